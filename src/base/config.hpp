@@ -88,11 +88,25 @@ constexpr std::size_t BC_DIFFICULTY_RECALCULATION_RATE = 2; // how many blocks m
 constexpr std::size_t BC_MAXIMAL_CHANGE_MULTIPLIER = 1'000'000'000; // times complexity could change at once
 constexpr std::size_t BC_EMISSION_VALUE = 1000;
 constexpr std::size_t BC_TOKEN_VALUE = 1'000'000'000;
+constexpr std::size_t BC_VERIFIED_SIGNATURES_CACHE_SIZE = 10'000; // hashes of transactions with checked signatures
+//------------------------
+
+// mempool
+constexpr std::size_t MEMPOOL_MAX_TRANSACTIONS = 100'000;
+constexpr std::size_t MEMPOOL_MAX_BYTES = 256 * 1024 * 1024; // 256MB of serialized transactions
+constexpr std::size_t MEMPOOL_TRANSACTION_LIFETIME = 3 * 60 * 60; // seconds since the transaction timestamp
+//------------------------
+
+// miner
+constexpr std::size_t MINER_JOB_UPDATE_INTERVAL = 200; // milliseconds during which new pending transactions
+                                                       // are coalesced into one miner restart
 //------------------------
 
 // websocket
-constexpr std::uint32_t PUBLIC_SERVICE_API_VERSION = 2;
+constexpr std::uint32_t PUBLIC_SERVICE_API_VERSION = 3;
 constexpr std::size_t PUBLIC_SERVICE_MESSAGE_BUFFER_SIZE = 16 * 1024; // 16KB
+constexpr std::size_t PUBLIC_SERVICE_HISTORY_PAGE_MAX_SIZE = 100;     // transactions hashes in one history page
+constexpr std::size_t PUBLIC_SERVICE_PUSH_BATCH_MAX_SIZE = 1000;      // transactions in one push_transactions call
 //--------------------
 
 // database
@@ -100,6 +114,10 @@ constexpr std::size_t DATABASE_WRITE_BUFFER_SIZE = 50 * 1024 * 1024;     // 50MB
 constexpr std::size_t DATABASE_DATA_BLOCK_SIZE = 10 * 1024;              // 10KB data-block size
 constexpr std::size_t DATABASE_DATA_BLOCK_CACHE_SIZE = 50 * 1024 * 1024; // 50MB data-block cache size
 constexpr bool DATABASE_COMPRESS_DATA = false;                           // no compress data
+constexpr std::size_t DATABASE_BLOCKS_CACHE_BYTES = 64 * 1024 * 1024;    // 64MB of encoded blocks kept in memory
+constexpr std::size_t DATABASE_STATE_SNAPSHOT_INTERVAL = 100;            // blocks between account-state snapshots
+constexpr std::size_t DATABASE_LOADING_WINDOW = 512;                     // blocks being loaded at once on start
+constexpr std::size_t DATABASE_TRANSACTIONS_STATUSES_CACHE_SIZE = 10'000; // statuses kept in memory
 //--------------------
 
 // keys paths
@@ -64,6 +64,53 @@ base::Bytes generate_bytes(std::size_t size)
 }
 
 
+/*
+ * Creating a context builds precomputed tables and costs far more than a signature operation, so one context is
+ * created for the process. All the functions used take it by a const pointer and are safe to call concurrently.
+ * It is randomized once to protect signing against side-channel attacks.
+ */
+const secp256k1_context* getSecpContext()
+{
+    static const std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context = [] {
+        std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> ret(
+          secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
+        auto seed = generate_bytes(32);
+        if (secp256k1_context_randomize(ret.get(), seed.getData()) == 0) {
+            LOG_WARNING << "Cannot randomize secp256k1 context";
+        }
+        return ret;
+    }();
+    return context.get();
+}
+
+
+// returns nullptr on success, otherwise the error description
+const char* recoverPublicKey(const base::Secp256PrivateKey::Signature& signature,
+                             const base::Sha256& hash,
+                             base::Secp256PrivateKey::PublicKey& output)
+{
+    const auto* context = getSecpContext();
+    secp256k1_ecdsa_recoverable_signature recoverable_signature;
+    if (secp256k1_ecdsa_recoverable_signature_parse_compact(
+          context, &recoverable_signature, signature.getData(), static_cast<int>(signature[signature.size() - 1])) ==
+        0) {
+        return "could not parsed signature";
+    }
+
+    secp256k1_pubkey pubkey;
+    if (secp256k1_ecdsa_recover(context, &pubkey, &recoverable_signature, hash.getBytes().getData()) == 0) {
+        return "recover public key is invalid";
+    }
+
+    std::size_t output_size = output.size();
+    secp256k1_ec_pubkey_serialize(context, output.getData(), &output_size, &pubkey, SECP256K1_EC_UNCOMPRESSED);
+    if (output_size == 0) {
+        return "secret key for create public key is invalid";
+    }
+    return nullptr;
+}
+
+
 base::Secp256PrivateKey loadOrGenerateKey(const std::string_view& keys_dir_path)
 {
     auto private_key_path = base::config::makePrivateKeyPath(keys_dir_path);
@@ -310,25 +357,22 @@ Secp256PrivateKey::Secp256PrivateKey(const PrivateKey& private_key_bytes)
 
 bool Secp256PrivateKey::is_valid() const
 {
-    std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context(
-      secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
-    return secp256k1_ec_seckey_verify(context.get(), _secp_key.getData()) == 1;
+    return secp256k1_ec_seckey_verify(getSecpContext(), _secp_key.getData()) == 1;
 }
 
 
 Secp256PrivateKey::PublicKey Secp256PrivateKey::toPublicKey() const
 {
-    std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context(
-      secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
+    const auto* context = getSecpContext();
     secp256k1_pubkey pubkey;
-    if (secp256k1_ec_pubkey_create(context.get(), &pubkey, _secp_key.toBytes().getData()) == 0) {
+    if (secp256k1_ec_pubkey_create(context, &pubkey, _secp_key.toBytes().getData()) == 0) {
         RAISE_ERROR(base::CryptoError, "secret key for create public key is invalid");
     }
 
     PublicKey output;
     std::size_t output_size = output.size();
 
-    secp256k1_ec_pubkey_serialize(context.get(), output.getData(), &output_size, &pubkey, SECP256K1_EC_UNCOMPRESSED);
+    secp256k1_ec_pubkey_serialize(context, output.getData(), &output_size, &pubkey, SECP256K1_EC_UNCOMPRESSED);
     if (output_size == 0) {
         RAISE_ERROR(base::CryptoError, "secret key for create public key is invalid");
     }
@@ -340,18 +384,17 @@ Secp256PrivateKey::PublicKey Secp256PrivateKey::toPublicKey() const
 Secp256PrivateKey::Signature Secp256PrivateKey::sign(const base::Bytes& bytes_to_sign) const
 {
     auto hash = base::Sha256::compute(bytes_to_sign);
-    std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context(
-      secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
+    const auto* context = getSecpContext();
     secp256k1_ecdsa_recoverable_signature recoverable_signature;
     if (secp256k1_ecdsa_sign_recoverable(
-          context.get(), &recoverable_signature, hash.getBytes().getData(), _secp_key.getData(), nullptr, nullptr) ==
+          context, &recoverable_signature, hash.getBytes().getData(), _secp_key.getData(), nullptr, nullptr) ==
         0) {
         RAISE_ERROR(base::CryptoError, "error signing bytes");
     }
     int rec_id = -1;
     base::Bytes serialized_recoverable_signature(64);
     secp256k1_ecdsa_recoverable_signature_serialize_compact(
-      context.get(), serialized_recoverable_signature.getData(), &rec_id, &recoverable_signature);
+      context, serialized_recoverable_signature.getData(), &rec_id, &recoverable_signature);
 
     if (rec_id == -1) {
         RAISE_ERROR(base::CryptoError, "signature serialization failed");
@@ -364,32 +407,27 @@ Secp256PrivateKey::Signature Secp256PrivateKey::sign(const base::Bytes& bytes_to
 Secp256PrivateKey::PublicKey Secp256PrivateKey::decodeSignatureToPublicKey(const Signature& signature,
                                                                            const base::Bytes& bytes_to_check)
 {
-    auto hash = base::Sha256::compute(bytes_to_check);
-    std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context(
-      secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
-
-    auto sig_data = signature.toBytes();
-    secp256k1_ecdsa_recoverable_signature recoverable_signature;
-    if (secp256k1_ecdsa_recoverable_signature_parse_compact(
-          context.get(), &recoverable_signature, sig_data.getData(), static_cast<int>(sig_data[sig_data.size() - 1])) ==
-        0) {
-        RAISE_ERROR(base::CryptoError, "could not parsed signature");
-    }
-
-    secp256k1_pubkey pubkey;
-    if (secp256k1_ecdsa_recover(context.get(), &pubkey, &recoverable_signature, hash.getBytes().getData()) == 0) {
-        RAISE_ERROR(base::CryptoError, "recover public key is invalid");
+    PublicKey output;
+    if (auto error = recoverPublicKey(signature, base::Sha256::compute(bytes_to_check), output)) {
+        RAISE_ERROR(base::CryptoError, error);
     }
+    return output;
+}
 
-    PublicKey output;
-    std::size_t output_size = output.size();
 
-    secp256k1_ec_pubkey_serialize(context.get(), output.getData(), &output_size, &pubkey, SECP256K1_EC_UNCOMPRESSED);
-    if (output_size == 0) {
-        RAISE_ERROR(base::CryptoError, "secret key for create public key is invalid");
+std::vector<std::optional<Secp256PrivateKey::PublicKey>> Secp256PrivateKey::decodeSignaturesToPublicKeys(
+  const std::vector<Signature>& signatures,
+  const std::vector<base::Bytes>& bytes_to_check)
+{
+    ASSERT(signatures.size() == bytes_to_check.size());
+    std::vector<std::optional<PublicKey>> ret(signatures.size());
+    for (std::size_t i = 0; i < signatures.size(); ++i) {
+        PublicKey output;
+        if (!recoverPublicKey(signatures[i], base::Sha256::compute(bytes_to_check[i]), output)) {
+            ret[i] = output;
+        }
     }
-
-    return output;
+    return ret;
 }
 
 
@@ -10,6 +10,8 @@
 #include <filesystem>
 #include <iosfwd>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace base
 {
@@ -83,6 +85,10 @@ class Secp256PrivateKey
     //---------------------------
     Signature sign(const base::Bytes& bytes_to_sign) const;
     static PublicKey decodeSignatureToPublicKey(const Signature& signature, const base::Bytes& bytes_to_check);
+    // same for many signatures at once, but instead of throwing gives std::nullopt for an invalid signature
+    static std::vector<std::optional<PublicKey>> decodeSignaturesToPublicKeys(
+      const std::vector<Signature>& signatures,
+      const std::vector<base::Bytes>& bytes_to_check);
     //---------------------------
     void save(const std::filesystem::path& path) const;
     static Secp256PrivateKey load(const std::filesystem::path& path);
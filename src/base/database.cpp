@@ -8,6 +8,25 @@
 namespace base
 {
 
+void Database::WriteBatch::clear()
+{
+    _batch.Clear();
+    _operations_count = 0;
+}
+
+
+std::size_t Database::WriteBatch::size() const noexcept
+{
+    return _operations_count;
+}
+
+
+bool Database::WriteBatch::isEmpty() const noexcept
+{
+    return _operations_count == 0;
+}
+
+
 Database::Database(Directory const& path)
 {
     open(path);
@@ -55,6 +74,81 @@ void Database::open(Directory const& path)
 }
 
 
+void Database::write(WriteBatch batch)
+{
+    _checkStatus();
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    leveldb::Status status;
+    if (_group_commit) {
+        PendingWrite pending_write{ &batch._batch, false, leveldb::Status{} };
+        status = _writeGroup(pending_write);
+    }
+    else {
+        status = _database->Write(_write_options, &batch._batch);
+    }
+
+    if (!status.ok()) {
+        RAISE_ERROR(base::DatabaseError, status.ToString());
+    }
+}
+
+
+void Database::enableGroupCommit()
+{
+    _checkStatus();
+    if (!_group_commit) {
+        _group_commit = std::make_unique<GroupCommitQueue>();
+    }
+}
+
+
+std::size_t Database::getCommittedGroupsCount() const
+{
+    if (!_group_commit) {
+        RAISE_ERROR(base::LogicError, "group commit is not enabled");
+    }
+    std::lock_guard lk(_group_commit->mutex);
+    return _group_commit->committed_groups_count;
+}
+
+
+leveldb::Status Database::_writeGroup(PendingWrite& write)
+{
+    std::unique_lock lk(_group_commit->mutex);
+    auto& pending_writes = _group_commit->pending_writes;
+    pending_writes.push_back(&write);
+    _group_commit->cv.wait(lk, [&] { return write.is_done || pending_writes.front() == &write; });
+    if (write.is_done) {
+        return write.status;
+    }
+
+    // this writer became a leader: it writes its batch together with all batches queued so far
+    leveldb::WriteBatch group;
+    const std::size_t group_size = pending_writes.size();
+    for (std::size_t i = 0; i < group_size; ++i) {
+        group.Append(*pending_writes[i]->batch);
+    }
+
+    lk.unlock();
+    auto status = _database->Write(_write_options, &group);
+    lk.lock();
+
+    ++_group_commit->committed_groups_count;
+    for (std::size_t i = 0; i < group_size; ++i) {
+        auto* member = pending_writes.front();
+        pending_writes.pop_front();
+        member->status = status;
+        member->is_done = true;
+    }
+    _group_commit->cv.notify_all();
+
+    return status;
+}
+
+
 void Database::_checkStatus() const
 {
     if (!_inited) {
@@ -5,9 +5,13 @@
 
 #include <leveldb/cache.h>
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -17,6 +21,37 @@ namespace base
 class Database
 {
   public:
+    /*
+     * Set of updates that are applied to database atomically.
+     */
+    class WriteBatch
+    {
+        friend Database;
+
+      public:
+        WriteBatch() = default;
+        WriteBatch(const WriteBatch&) = default;
+        WriteBatch(WriteBatch&&) = default;
+        WriteBatch& operator=(const WriteBatch&) = default;
+        WriteBatch& operator=(WriteBatch&&) = default;
+        ~WriteBatch() = default;
+        //======================
+        template<typename B1, typename B2> // expects base::Bytes or base::FixedBytes<>
+        void put(const B1& key, const B2& value);
+
+        template<typename B>
+        void remove(const B& key);
+
+        void clear();
+        //======================
+        std::size_t size() const noexcept;
+        bool isEmpty() const noexcept;
+        //======================
+      private:
+        leveldb::WriteBatch _batch;
+        std::size_t _operations_count{ 0 };
+    };
+    //======================
     explicit Database() = default;
     explicit Database(Directory const& path);
     Database(Database&&) = default;
@@ -37,15 +72,48 @@ class Database
     template<typename B>
     void remove(const B& key);
     //======================
+    /*
+     * Applies all updates of the batch atomically with a single synced write.
+     * If group commit is enabled, batches of concurrent writers are merged and written together.
+     */
+    void write(WriteBatch batch);
+
+    /*
+     * Must be called before the database is used by several threads.
+     */
+    void enableGroupCommit();
+
+    /*
+     * Number of synced writes done in group commit mode: each of them applies batches of one or more writers.
+     */
+    std::size_t getCommittedGroupsCount() const;
+    //======================
   private:
+    //======================
+    struct PendingWrite
+    {
+        const leveldb::WriteBatch* batch;
+        bool is_done{ false };
+        leveldb::Status status;
+    };
+
+    struct GroupCommitQueue
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<PendingWrite*> pending_writes;
+        std::size_t committed_groups_count{ 0 };
+    };
     //======================
     bool _inited{ false };
     std::unique_ptr<leveldb::DB> _database;
     leveldb::ReadOptions _read_options;
     leveldb::WriteOptions _write_options;
     std::unique_ptr<leveldb::Cache> _cache;
+    std::unique_ptr<GroupCommitQueue> _group_commit;
     //=====================
     void _checkStatus() const;
+    leveldb::Status _writeGroup(PendingWrite& write);
     //=====================
 };
 
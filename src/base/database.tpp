@@ -2,6 +2,22 @@
 
 namespace base
 {
+template<typename B1, typename B2>
+void Database::WriteBatch::put(const B1& key, const B2& value)
+{
+    _batch.Put(key.toString(), value.toString());
+    ++_operations_count;
+}
+
+
+template<typename B>
+void Database::WriteBatch::remove(const B& key)
+{
+    _batch.Delete(key.toString());
+    ++_operations_count;
+}
+
+
 template<typename B1, typename B2>
 void Database::put(const B1& key, const B2& value)
 {
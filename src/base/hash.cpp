@@ -7,6 +7,8 @@
 #include <openssl/ripemd.h>
 #include <openssl/sha.h>
 
+#include <algorithm>
+#include <cstring>
 #include <stdint.h>
 #include <string>
 
@@ -91,6 +93,37 @@ Sha256 Sha256::compute(const base::Bytes& data)
 }
 
 
+std::vector<Sha256> Sha256::computeMany(const std::vector<base::Bytes>& messages)
+{
+    std::vector<const Byte*> data;
+    std::vector<std::size_t> lengths;
+    data.reserve(messages.size());
+    lengths.reserve(messages.size());
+    for (const auto& message : messages) {
+        data.push_back(message.getData());
+        lengths.push_back(message.size());
+    }
+
+    std::vector<FixedBytes<LENGTH>> digests(messages.size());
+    impl::sha256FinalizeMany(impl::getMultiStreamSha256Kernel(),
+                             impl::SHA256_INITIAL_STATE,
+                             0,
+                             nullptr,
+                             0,
+                             data.data(),
+                             lengths.data(),
+                             messages.size(),
+                             digests.data());
+
+    std::vector<Sha256> ret;
+    ret.reserve(digests.size());
+    for (auto& digest : digests) {
+        ret.emplace_back(std::move(digest));
+    }
+    return ret;
+}
+
+
 void Sha256::serialize(SerializationOArchive& oa) const
 {
     oa.serialize(_bytes);
@@ -108,12 +141,96 @@ std::ostream& operator<<(std::ostream& os, const Sha256& sha)
     return os << toHex<FixedBytes<Sha256::LENGTH>>(sha.getBytes());
 }
 
+
+Sha256Builder::Sha256Builder()
+  : _state{ impl::SHA256_INITIAL_STATE }
+  , _buffer{}
+  , _length{ 0 }
+{}
+
+
+void Sha256Builder::update(const Byte* data, std::size_t length)
+{
+    const auto& kernel = impl::getSingleStreamSha256Kernel();
+    auto buffered = static_cast<std::size_t>(_length % impl::SHA256_BLOCK_SIZE);
+    _length += length;
+
+    if (buffered > 0) {
+        const auto taken = std::min(impl::SHA256_BLOCK_SIZE - buffered, length);
+        std::memcpy(_buffer.data() + buffered, data, taken);
+        data += taken;
+        length -= taken;
+        buffered += taken;
+        if (buffered < impl::SHA256_BLOCK_SIZE) {
+            return;
+        }
+        const Byte* block = _buffer.data();
+        kernel.compress_many(&_state, &block, 1);
+    }
+
+    for (; length >= impl::SHA256_BLOCK_SIZE; data += impl::SHA256_BLOCK_SIZE, length -= impl::SHA256_BLOCK_SIZE) {
+        kernel.compress_many(&_state, &data, 1);
+    }
+    if (length > 0) {
+        std::memcpy(_buffer.data(), data, length);
+    }
+}
+
+
+void Sha256Builder::update(const Bytes& data)
+{
+    update(data.getData(), data.size());
+}
+
+
+void Sha256Builder::update(std::string_view data)
+{
+    update(reinterpret_cast<const Byte*>(data.data()), data.size());
+}
+
+
+Sha256 Sha256Builder::finalize() const
+{
+    const Byte* no_suffix = nullptr;
+    base::FixedBytes<Sha256::LENGTH> ret;
+    impl::sha256FinalizeMany(impl::getSingleStreamSha256Kernel(),
+                             _state,
+                             _length - _length % impl::SHA256_BLOCK_SIZE,
+                             _buffer.data(),
+                             _length % impl::SHA256_BLOCK_SIZE,
+                             &no_suffix,
+                             std::size_t{ 0 },
+                             1,
+                             &ret);
+    return Sha256(ret);
+}
+
+
+void Sha256Builder::finalizeMany(const Byte* const* suffixes,
+                                 std::size_t suffix_length,
+                                 std::size_t count,
+                                 FixedBytes<Sha256::LENGTH>* digests) const
+{
+    impl::sha256FinalizeMany(impl::getMultiStreamSha256Kernel(),
+                             _state,
+                             _length - _length % impl::SHA256_BLOCK_SIZE,
+                             _buffer.data(),
+                             _length % impl::SHA256_BLOCK_SIZE,
+                             suffixes,
+                             suffix_length,
+                             count,
+                             digests);
+}
+
 } // namespace base
 
 
 std::size_t std::hash<base::Sha256>::operator()(const base::Sha256& k) const
 {
-    return std::hash<base::FixedBytes<base::Sha256::LENGTH>>{}(k.getBytes());
+    // digest bytes are already uniformly distributed, so there is no need to mix all of them
+    std::size_t ret;
+    std::memcpy(&ret, k.getBytes().getData(), sizeof(ret));
+    return ret;
 }
 
 
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "base/serialization.hpp"
+#include "base/sha256_kernels.hpp"
 
 #include <functional>
 #include <iosfwd>
+#include <string_view>
+#include <vector>
 
 namespace base
 {
@@ -37,6 +40,13 @@ class Sha256
 
     template<std::size_t S>
     static Sha256 compute(const base::FixedBytes<S>& data);
+
+    /*
+     * Hashes a batch of messages at once: independent messages go through the multi-buffer kernel (8 AVX2 lanes or
+     * SHA extensions, chosen at startup by the CPU features). Works with any lengths, but messages of the same
+     * length fill the lanes best.
+     */
+    static std::vector<Sha256> computeMany(const std::vector<base::Bytes>& messages);
     //----------------------------------
     void serialize(SerializationOArchive& oa) const;
     static Sha256 deserialize(SerializationIArchive& ia);
@@ -47,6 +57,42 @@ class Sha256
 
 std::ostream& operator<<(std::ostream& os, const Sha256& sha);
 
+
+/*
+ * Incremental SHA-256: data is hashed part by part, so it doesn't have to be concatenated first.
+ * The state is a plain value, so a copy of the builder continues from the already hashed prefix.
+ */
+class Sha256Builder
+{
+  public:
+    //----------------------------------
+    Sha256Builder();
+    Sha256Builder(const Sha256Builder&) = default;
+    Sha256Builder& operator=(const Sha256Builder&) = default;
+    ~Sha256Builder() = default;
+    //----------------------------------
+    void update(const Byte* data, std::size_t length);
+    void update(const Bytes& data);
+    void update(std::string_view data);
+    //----------------------------------
+    // doesn't change the state, so more data can be added after that
+    Sha256 finalize() const;
+
+    /*
+     * Finishes count hashes at once: hash i is of the data added so far followed by suffixes[i].
+     * All the suffixes are suffix_length bytes long. Used to try many endings of the same prefix, e.g. nonces.
+     */
+    void finalizeMany(const Byte* const* suffixes,
+                      std::size_t suffix_length,
+                      std::size_t count,
+                      FixedBytes<Sha256::LENGTH>* digests) const;
+    //----------------------------------
+  private:
+    impl::Sha256State _state;
+    std::array<Byte, impl::SHA256_BLOCK_SIZE> _buffer;
+    std::uint64_t _length; // of all added data, the last _length % SHA256_BLOCK_SIZE bytes are in the _buffer
+};
+
 } // namespace base
 
 
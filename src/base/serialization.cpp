@@ -12,6 +12,12 @@ void SerializationOArchive::clear()
 }
 
 
+void SerializationOArchive::serializeRaw(const base::Bytes& serialized)
+{
+    _bytes.append(serialized);
+}
+
+
 const base::Bytes& SerializationOArchive::getBytes() const& noexcept
 {
     return _bytes;
@@ -48,6 +48,9 @@ class SerializationOArchive
 
     template<typename U, typename V>
     void serialize(const std::pair<U, V>& p);
+
+    // appends bytes that are already serialized, without a size prefix
+    void serializeRaw(const base::Bytes& serialized);
     //=================
     const base::Bytes& getBytes() const& noexcept;
     base::Bytes&& getBytes() && noexcept;
@@ -0,0 +1,505 @@
+#include "sha256_kernels.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LK_SHA256_X86_KERNELS
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace base::impl
+{
+
+namespace
+{
+
+alignas(16) constexpr std::array<std::uint32_t, 64> ROUND_CONSTANTS{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+inline std::uint32_t loadBigEndian32(const Byte* data)
+{
+    return (std::uint32_t{ data[0] } << 24) | (std::uint32_t{ data[1] } << 16) | (std::uint32_t{ data[2] } << 8) |
+           std::uint32_t{ data[3] };
+}
+
+
+inline void storeBigEndian32(Byte* data, std::uint32_t value)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        data[i] = static_cast<Byte>(value >> (8 * (sizeof(value) - 1 - i)));
+    }
+}
+
+
+inline void storeBigEndian64(Byte* data, std::uint64_t value)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        data[i] = static_cast<Byte>(value >> (8 * (sizeof(value) - 1 - i)));
+    }
+}
+
+//====================================
+
+constexpr std::uint32_t rotateRight(std::uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+
+void compressScalar(Sha256State& state, const Byte* block)
+{
+    std::array<std::uint32_t, 64> w;
+    for (std::size_t t = 0; t < 16; ++t) {
+        w[t] = loadBigEndian32(block + 4 * t);
+    }
+    for (std::size_t t = 16; t < 64; ++t) {
+        const auto s0 = rotateRight(w[t - 15], 7) ^ rotateRight(w[t - 15], 18) ^ (w[t - 15] >> 3);
+        const auto s1 = rotateRight(w[t - 2], 17) ^ rotateRight(w[t - 2], 19) ^ (w[t - 2] >> 10);
+        w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+    for (std::size_t t = 0; t < 64; ++t) {
+        const auto s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        const auto ch = (e & f) ^ (~e & g);
+        const auto t1 = h + s1 + ch + ROUND_CONSTANTS[t] + w[t];
+        const auto s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        const auto maj = (a & b) | (c & (a | b));
+        const auto t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+
+void compressManyScalar(Sha256State* states, const Byte* const* blocks, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        compressScalar(states[i], blocks[i]);
+    }
+}
+
+
+const Sha256Kernel SCALAR_KERNEL{ "scalar", compressManyScalar };
+
+//====================================
+
+#ifdef LK_SHA256_X86_KERNELS
+
+#define LK_TARGET_AVX2 __attribute__((target("avx2")))
+#define LK_TARGET_SHA __attribute__((target("sha,sse4.1,ssse3")))
+
+constexpr std::size_t AVX2_LANES = 8;
+
+
+template<int N>
+LK_TARGET_AVX2 inline __m256i rotateRight8(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+
+LK_TARGET_AVX2 inline __m256i add8(__m256i x, __m256i y)
+{
+    return _mm256_add_epi32(x, y);
+}
+
+
+LK_TARGET_AVX2 inline __m256i xor8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+}
+
+
+// one block for each of 8 lanes: every 32-bit word of a vector belongs to its own lane
+LK_TARGET_AVX2 void compressEightLanesAvx2(Sha256State* const* states, const Byte* const* blocks)
+{
+    alignas(32) std::array<std::uint32_t, AVX2_LANES> words;
+
+    __m256i w[64];
+    for (std::size_t t = 0; t < 16; ++t) {
+        for (std::size_t lane = 0; lane < AVX2_LANES; ++lane) {
+            words[lane] = loadBigEndian32(blocks[lane] + 4 * t);
+        }
+        w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(words.data()));
+    }
+    for (std::size_t t = 16; t < 64; ++t) {
+        const auto s0 = xor8(rotateRight8<7>(w[t - 15]), rotateRight8<18>(w[t - 15]), _mm256_srli_epi32(w[t - 15], 3));
+        const auto s1 = xor8(rotateRight8<17>(w[t - 2]), rotateRight8<19>(w[t - 2]), _mm256_srli_epi32(w[t - 2], 10));
+        w[t] = add8(add8(w[t - 16], s0), add8(w[t - 7], s1));
+    }
+
+    __m256i initial[8];
+    for (std::size_t i = 0; i < 8; ++i) {
+        for (std::size_t lane = 0; lane < AVX2_LANES; ++lane) {
+            words[lane] = (*states[lane])[i];
+        }
+        initial[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(words.data()));
+    }
+
+    auto a = initial[0], b = initial[1], c = initial[2], d = initial[3];
+    auto e = initial[4], f = initial[5], g = initial[6], h = initial[7];
+    for (std::size_t t = 0; t < 64; ++t) {
+        const auto s1 = xor8(rotateRight8<6>(e), rotateRight8<11>(e), rotateRight8<25>(e));
+        const auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const auto k = _mm256_set1_epi32(static_cast<int>(ROUND_CONSTANTS[t]));
+        const auto t1 = add8(add8(add8(h, s1), add8(ch, k)), w[t]);
+        const auto s0 = xor8(rotateRight8<2>(a), rotateRight8<13>(a), rotateRight8<22>(a));
+        const auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        const auto t2 = add8(s0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = add8(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = add8(t1, t2);
+    }
+
+    const __m256i result[8]{ add8(initial[0], a), add8(initial[1], b), add8(initial[2], c), add8(initial[3], d),
+                             add8(initial[4], e), add8(initial[5], f), add8(initial[6], g), add8(initial[7], h) };
+    for (std::size_t i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words.data()), result[i]);
+        for (std::size_t lane = 0; lane < AVX2_LANES; ++lane) {
+            (*states[lane])[i] = words[lane];
+        }
+    }
+}
+
+
+LK_TARGET_AVX2 void compressManyAvx2(Sha256State* states, const Byte* const* blocks, std::size_t count)
+{
+    for (std::size_t first = 0; first < count; first += AVX2_LANES) {
+        const auto lanes_count = std::min(AVX2_LANES, count - first);
+        // a partial group is filled up with copies of its first block, the results of them are thrown away
+        std::array<Sha256State, AVX2_LANES> spare_states;
+        std::array<Sha256State*, AVX2_LANES> lanes_states;
+        std::array<const Byte*, AVX2_LANES> lanes_blocks;
+        for (std::size_t lane = 0; lane < AVX2_LANES; ++lane) {
+            if (lane < lanes_count) {
+                lanes_states[lane] = &states[first + lane];
+                lanes_blocks[lane] = blocks[first + lane];
+            }
+            else {
+                spare_states[lane] = SHA256_INITIAL_STATE;
+                lanes_states[lane] = &spare_states[lane];
+                lanes_blocks[lane] = blocks[first];
+            }
+        }
+        compressEightLanesAvx2(lanes_states.data(), lanes_blocks.data());
+    }
+}
+
+
+const Sha256Kernel AVX2_KERNEL{ "avx2", compressManyAvx2 };
+
+//====================================
+
+// the instruction sequence follows the Intel SHA extensions reference: states are kept as ABEF and CDGH
+LK_TARGET_SHA void compressShaExtensions(Sha256State& state, const Byte* block)
+{
+    const auto byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    auto tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1); // CDAB
+    auto state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B); // EFGH
+    auto state0 = _mm_alignr_epi8(tmp, state1, 8);                                                      // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);                                                        // CDGH
+    const auto abef_save = state0;
+    const auto cdgh_save = state1;
+
+    __m128i msg[4];
+    for (std::size_t group = 0; group < 16; ++group) {
+        auto& current = msg[group % 4];
+        if (group < 4) {
+            current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * group)),
+                                       byte_swap_mask);
+        }
+        auto rounds_input = _mm_add_epi32(
+          current, _mm_load_si128(reinterpret_cast<const __m128i*>(ROUND_CONSTANTS.data() + 4 * group)));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, rounds_input);
+        if (group >= 3 && group <= 14) {
+            auto& next = msg[(group + 1) % 4];
+            next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(group + 3) % 4], 4));
+            next = _mm_sha256msg2_epu32(next, current);
+        }
+        rounds_input = _mm_shuffle_epi32(rounds_input, 0x0E);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, rounds_input);
+        if (group >= 1 && group <= 12) {
+            auto& previous = msg[(group + 3) % 4];
+            previous = _mm_sha256msg1_epu32(previous, current);
+        }
+    }
+
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);    // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0)); // DCBA
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8));   // HGFE
+}
+
+
+LK_TARGET_SHA void compressManyShaExtensions(Sha256State* states, const Byte* const* blocks, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        compressShaExtensions(states[i], blocks[i]);
+    }
+}
+
+
+const Sha256Kernel SHA_EXTENSIONS_KERNEL{ "sha-ni", compressManyShaExtensions };
+
+//====================================
+
+bool isAvx2Supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+
+bool areShaExtensionsSupported()
+{
+    __builtin_cpu_init();
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    constexpr unsigned int SHA_BIT = 1u << 29;
+    return (ebx & SHA_BIT) && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3");
+}
+
+#endif
+
+//====================================
+
+std::size_t getPaddedLength(std::size_t length)
+{
+    // 0x80 byte and 64-bit length of the message in bits
+    return (length + 1 + sizeof(std::uint64_t) + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE * SHA256_BLOCK_SIZE;
+}
+
+
+// the block which starts at block_begin in head + message + padding
+const Byte* getBlock(std::size_t block_begin,
+                     const Byte* head,
+                     std::size_t head_length,
+                     const Byte* message,
+                     std::size_t message_length,
+                     std::uint64_t total_length,
+                     std::array<Byte, SHA256_BLOCK_SIZE>& buffer)
+{
+    const auto block_end = block_begin + SHA256_BLOCK_SIZE;
+    const auto message_end = head_length + message_length;
+    if (block_begin >= head_length && block_end <= message_end) {
+        return message + (block_begin - head_length);
+    }
+
+    std::memset(buffer.data(), 0, buffer.size());
+    if (block_begin < head_length) {
+        std::memcpy(buffer.data(), head + block_begin, std::min(head_length, block_end) - block_begin);
+    }
+    const auto copy_begin = std::max(block_begin, head_length);
+    const auto copy_end = std::min(block_end, message_end);
+    if (copy_begin < copy_end) {
+        std::memcpy(buffer.data() + (copy_begin - block_begin),
+                    message + (copy_begin - head_length),
+                    copy_end - copy_begin);
+    }
+    if (message_end >= block_begin && message_end < block_end) {
+        buffer[message_end - block_begin] = 0x80;
+    }
+    if (block_end == getPaddedLength(message_end)) {
+        storeBigEndian64(buffer.data() + SHA256_BLOCK_SIZE - sizeof(std::uint64_t), total_length * 8);
+    }
+    return buffer.data();
+}
+
+
+template<typename LengthGetter>
+void finalizeMany(const Sha256Kernel& kernel,
+                  const Sha256State& initial_state,
+                  std::uint64_t compressed_length,
+                  const Byte* head,
+                  std::size_t head_length,
+                  const Byte* const* messages,
+                  const LengthGetter& get_length,
+                  std::size_t count,
+                  FixedBytes<SHA256_DIGEST_SIZE>* digests)
+{
+    ASSERT(compressed_length % SHA256_BLOCK_SIZE == 0);
+    ASSERT(head_length < SHA256_BLOCK_SIZE);
+
+    // messages are processed in groups: block number i of every message of a group goes to the kernel at once
+    constexpr std::size_t GROUP_SIZE = 8;
+    for (std::size_t first = 0; first < count; first += GROUP_SIZE) {
+        const auto group_size = std::min(GROUP_SIZE, count - first);
+        std::array<Sha256State, GROUP_SIZE> states;
+        std::array<std::size_t, GROUP_SIZE> blocks_counts;
+        std::array<const Byte*, GROUP_SIZE> blocks;
+        std::array<std::array<Byte, SHA256_BLOCK_SIZE>, GROUP_SIZE> buffers;
+        std::size_t max_blocks_count = 0;
+        for (std::size_t lane = 0; lane < group_size; ++lane) {
+            states[lane] = initial_state;
+            blocks_counts[lane] = getPaddedLength(head_length + get_length(first + lane)) / SHA256_BLOCK_SIZE;
+            max_blocks_count = std::max(max_blocks_count, blocks_counts[lane]);
+        }
+
+        for (std::size_t block_index = 0; block_index < max_blocks_count; ++block_index) {
+            for (std::size_t lane = 0; lane < group_size; ++lane) {
+                if (block_index < blocks_counts[lane]) {
+                    const auto length = get_length(first + lane);
+                    blocks[lane] = getBlock(block_index * SHA256_BLOCK_SIZE,
+                                            head,
+                                            head_length,
+                                            messages[first + lane],
+                                            length,
+                                            compressed_length + head_length + length,
+                                            buffers[lane]);
+                }
+                else {
+                    // the digest of the lane is already taken, whatever is compressed into it doesn't matter
+                    blocks[lane] = buffers[lane].data();
+                }
+            }
+            kernel.compress_many(states.data(), blocks.data(), group_size);
+            for (std::size_t lane = 0; lane < group_size; ++lane) {
+                if (block_index + 1 == blocks_counts[lane]) {
+                    for (std::size_t i = 0; i < states[lane].size(); ++i) {
+                        storeBigEndian32(digests[first + lane].getData() + 4 * i, states[lane][i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+//====================================
+
+const std::vector<const Sha256Kernel*>& getSupportedSha256Kernels()
+{
+    static const auto kernels = [] {
+        std::vector<const Sha256Kernel*> ret{ &SCALAR_KERNEL };
+#ifdef LK_SHA256_X86_KERNELS
+        if (isAvx2Supported()) {
+            ret.push_back(&AVX2_KERNEL);
+        }
+        if (areShaExtensionsSupported()) {
+            ret.push_back(&SHA_EXTENSIONS_KERNEL);
+        }
+#endif
+        return ret;
+    }();
+    return kernels;
+}
+
+
+const Sha256Kernel& getSingleStreamSha256Kernel()
+{
+    static const Sha256Kernel& kernel = [] () -> const Sha256Kernel& {
+#ifdef LK_SHA256_X86_KERNELS
+        if (areShaExtensionsSupported()) {
+            return SHA_EXTENSIONS_KERNEL;
+        }
+#endif
+        return SCALAR_KERNEL;
+    }();
+    return kernel;
+}
+
+
+const Sha256Kernel& getMultiStreamSha256Kernel()
+{
+    static const Sha256Kernel& kernel = [] () -> const Sha256Kernel& {
+#ifdef LK_SHA256_X86_KERNELS
+        if (areShaExtensionsSupported()) {
+            return SHA_EXTENSIONS_KERNEL;
+        }
+        if (isAvx2Supported()) {
+            return AVX2_KERNEL;
+        }
+#endif
+        return SCALAR_KERNEL;
+    }();
+    return kernel;
+}
+
+
+void sha256FinalizeMany(const Sha256Kernel& kernel,
+                        const Sha256State& initial_state,
+                        std::uint64_t compressed_length,
+                        const Byte* head,
+                        std::size_t head_length,
+                        const Byte* const* messages,
+                        const std::size_t* messages_lengths,
+                        std::size_t count,
+                        FixedBytes<SHA256_DIGEST_SIZE>* digests)
+{
+    finalizeMany(
+      kernel,
+      initial_state,
+      compressed_length,
+      head,
+      head_length,
+      messages,
+      [messages_lengths](std::size_t i) { return messages_lengths[i]; },
+      count,
+      digests);
+}
+
+
+void sha256FinalizeMany(const Sha256Kernel& kernel,
+                        const Sha256State& initial_state,
+                        std::uint64_t compressed_length,
+                        const Byte* head,
+                        std::size_t head_length,
+                        const Byte* const* messages,
+                        std::size_t messages_length,
+                        std::size_t count,
+                        FixedBytes<SHA256_DIGEST_SIZE>* digests)
+{
+    finalizeMany(
+      kernel,
+      initial_state,
+      compressed_length,
+      head,
+      head_length,
+      messages,
+      [messages_length](std::size_t) { return messages_length; },
+      count,
+      digests);
+}
+
+} // namespace base::impl
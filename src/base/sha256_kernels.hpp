@@ -0,0 +1,68 @@
+#pragma once
+
+#include "base/bytes.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace base::impl
+{
+
+constexpr std::size_t SHA256_BLOCK_SIZE = 64;  // bytes
+constexpr std::size_t SHA256_DIGEST_SIZE = 32; // bytes
+
+using Sha256State = std::array<std::uint32_t, 8>;
+
+constexpr Sha256State SHA256_INITIAL_STATE{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+
+/*
+ * An implementation of the SHA-256 compression function: block i is compressed into state i,
+ * all the pairs are independent, so a kernel is free to process them in parallel.
+ */
+struct Sha256Kernel
+{
+    const char* name;
+    void (*compress_many)(Sha256State* states, const Byte* const* blocks, std::size_t count);
+};
+
+// kernels the running CPU supports, the scalar one goes first and is always present
+const std::vector<const Sha256Kernel*>& getSupportedSha256Kernels();
+
+// chosen once at startup: the fastest kernel for a single sequence of blocks
+const Sha256Kernel& getSingleStreamSha256Kernel();
+
+// chosen once at startup: the fastest kernel for many independent sequences of blocks
+const Sha256Kernel& getMultiStreamSha256Kernel();
+
+
+/*
+ * Finishes hashing of count messages. Every message i is made of:
+ *  1) compressed_length bytes (a multiple of the block size) already compressed into initial_state;
+ *  2) head_length bytes of head, common for all the messages;
+ *  3) its own messages_lengths[i] bytes of messages[i].
+ */
+void sha256FinalizeMany(const Sha256Kernel& kernel,
+                        const Sha256State& initial_state,
+                        std::uint64_t compressed_length,
+                        const Byte* head,
+                        std::size_t head_length,
+                        const Byte* const* messages,
+                        const std::size_t* messages_lengths,
+                        std::size_t count,
+                        FixedBytes<SHA256_DIGEST_SIZE>* digests);
+
+// the same, but all the messages have the same length
+void sha256FinalizeMany(const Sha256Kernel& kernel,
+                        const Sha256State& initial_state,
+                        std::uint64_t compressed_length,
+                        const Byte* head,
+                        std::size_t head_length,
+                        const Byte* const* messages,
+                        std::size_t messages_length,
+                        std::size_t count,
+                        FixedBytes<SHA256_DIGEST_SIZE>* digests);
+
+} // namespace base::impl
@@ -6,8 +6,13 @@
 #include <functional>
 #include <map>
 #include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <unordered_map>
 
 namespace base
 {
@@ -103,6 +108,59 @@ class Queue
     std::condition_variable _has_task;
 };
 
+
+/*
+ * Thread-safe least-recently-used cache. Both find and put mark the entry as the most recently used one;
+ * when the capacity is exceeded the least recently used entries are dropped. The capacity bounds the total
+ * weight of entries, which is 1 per entry unless put is given another weight (the most recent entry is
+ * always kept, even if it alone outweighs the capacity).
+ */
+template<typename Key, typename Value>
+class LruCache
+{
+  public:
+    struct Stats
+    {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t size;
+        std::size_t weight;
+        std::size_t capacity;
+    };
+
+    explicit LruCache(std::size_t capacity);
+    LruCache(const LruCache&) = delete;
+    LruCache(LruCache&&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+    LruCache& operator=(LruCache&&) = delete;
+    ~LruCache() = default;
+
+    std::optional<Value> find(const Key& key);
+    void put(const Key& key, Value value, std::size_t weight = 1);
+    void remove(const Key& key);
+    void clear();
+
+    std::size_t size() const;
+    std::size_t capacity() const noexcept;
+    Stats getStats() const;
+
+  private:
+    struct Item
+    {
+        Key key;
+        Value value;
+        std::size_t weight;
+    };
+
+    const std::size_t _capacity;
+    std::size_t _weight{ 0 };
+    std::list<Item> _items; // most recently used are at front
+    std::unordered_map<Key, typename std::list<Item>::iterator> _index;
+    std::size_t _hits{ 0 };
+    std::size_t _misses{ 0 };
+    mutable std::mutex _mutex;
+};
+
 } // namespace base
 
 #include "utility.tpp"
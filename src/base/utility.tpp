@@ -171,4 +171,98 @@ bool Queue<Type>::empty() const
     return _tasks.empty();
 }
 
-} // namespace base
\ No newline at end of file
+
+template<typename Key, typename Value>
+LruCache<Key, Value>::LruCache(std::size_t capacity)
+  : _capacity{ capacity }
+{
+    if (_capacity == 0) {
+        RAISE_ERROR(base::InvalidArgument, "cache capacity must be positive");
+    }
+}
+
+
+template<typename Key, typename Value>
+std::optional<Value> LruCache<Key, Value>::find(const Key& key)
+{
+    std::lock_guard lk(_mutex);
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        ++_misses;
+        return std::nullopt;
+    }
+    ++_hits;
+    _items.splice(_items.begin(), _items, it->second);
+    return it->second->value;
+}
+
+
+template<typename Key, typename Value>
+void LruCache<Key, Value>::put(const Key& key, Value value, std::size_t weight)
+{
+    std::lock_guard lk(_mutex);
+    if (auto it = _index.find(key); it != _index.end()) {
+        _weight = _weight - it->second->weight + weight;
+        it->second->value = std::move(value);
+        it->second->weight = weight;
+        _items.splice(_items.begin(), _items, it->second);
+    }
+    else {
+        _items.push_front(Item{ key, std::move(value), weight });
+        _index.insert({ key, _items.begin() });
+        _weight += weight;
+    }
+
+    while (_weight > _capacity && _items.size() > 1) {
+        _weight -= _items.back().weight;
+        _index.erase(_items.back().key);
+        _items.pop_back();
+    }
+}
+
+
+template<typename Key, typename Value>
+void LruCache<Key, Value>::remove(const Key& key)
+{
+    std::lock_guard lk(_mutex);
+    if (auto it = _index.find(key); it != _index.end()) {
+        _weight -= it->second->weight;
+        _items.erase(it->second);
+        _index.erase(it);
+    }
+}
+
+
+template<typename Key, typename Value>
+void LruCache<Key, Value>::clear()
+{
+    std::lock_guard lk(_mutex);
+    _items.clear();
+    _index.clear();
+    _weight = 0;
+}
+
+
+template<typename Key, typename Value>
+std::size_t LruCache<Key, Value>::size() const
+{
+    std::lock_guard lk(_mutex);
+    return _items.size();
+}
+
+
+template<typename Key, typename Value>
+std::size_t LruCache<Key, Value>::capacity() const noexcept
+{
+    return _capacity;
+}
+
+
+template<typename Key, typename Value>
+typename LruCache<Key, Value>::Stats LruCache<Key, Value>::getStats() const
+{
+    std::lock_guard lk(_mutex);
+    return { _hits, _misses, _items.size(), _weight, _capacity };
+}
+
+} // namespace base
@@ -182,6 +182,20 @@ std::optional<lk::BlockDepth> takeDepth(Client& client, const std::string depth_
 }
 
 
+std::optional<std::uint64_t> takeNumber(Client& client, const std::string number_str)
+{
+    std::uint64_t number;
+    try {
+        number = std::stoull(number_str);
+    }
+    catch (const std::exception&) {
+        client.output("Wrong number was entered: " + number_str);
+        return {};
+    }
+    return number;
+}
+
+
 std::optional<base::Sha256> takeHash(Client& client, const std::string hash, bool continue_work = false)
 {
     base::FixedBytes<base::Sha256::LENGTH> hash_bytes;
@@ -1203,6 +1217,76 @@ void AccountInfoCommand::execute()
 }
 
 
+AccountTransactionsCommand::AccountTransactionsCommand(Client& client)
+  : Command(client, 3)
+{}
+
+
+const std::string& AccountTransactionsCommand::name() const noexcept
+{
+    static std::string name{ "account_transactions" };
+    return name;
+}
+
+
+const std::string& AccountTransactionsCommand::description() const noexcept
+{
+    static std::string description{ "Get a page of hashes of transactions sent from specific address" };
+    return description;
+}
+
+
+const std::string& AccountTransactionsCommand::argumentsHelpMessage() const noexcept
+{
+    static std::string help_message{ "<address of base58/contact name> <first sequence number> <count>" };
+    return help_message;
+}
+
+
+bool AccountTransactionsCommand::prepareArgs()
+{
+    auto arguments = parseAllArguments(_args);
+    if (arguments.size() != _count_arguments) {
+        _client.output("Wrong number of arguments for the " + name() + " command");
+        return false;
+    }
+    auto contacts = _client.getContacts();
+    auto contact = contacts.find(arguments[0]);
+    _address = contact != contacts.end() ? contact->second : takeAddress(_client, arguments[0]);
+    if (!_address) {
+        return false;
+    }
+
+    _from = takeNumber(_client, arguments[1]);
+    if (!_from) {
+        return false;
+    }
+
+    _count = takeNumber(_client, arguments[2]);
+    if (!_count) {
+        return false;
+    }
+
+    return true;
+}
+
+
+void AccountTransactionsCommand::execute()
+{
+    if (!_client.isConnected()) {
+        _client.output("You have to connect to likelib node");
+        return;
+    }
+
+    LOG_INFO << "account_transactions for address: " << _address.value();
+    auto request_args = base::json::Value::object();
+    request_args["address"] = websocket::serializeAddress(_address.value());
+    request_args["from"] = base::json::Value::number(_from.value());
+    request_args["count"] = base::json::Value::number(_count.value());
+    _client._web_socket_client.send(websocket::Command::CALL_ACCOUNT_TRANSACTIONS, std::move(request_args));
+}
+
+
 FeeInfoCommand::FeeInfoCommand(Client& client)
   : Command(client, 0)
 {}
@@ -297,6 +297,23 @@ class AccountInfoCommand final : public Command
 };
 
 
+class AccountTransactionsCommand final : public Command
+{
+  public:
+    AccountTransactionsCommand(Client& client);
+    const std::string& name() const noexcept override;
+    const std::string& description() const noexcept override;
+    const std::string& argumentsHelpMessage() const noexcept override;
+
+  protected:
+    bool prepareArgs() override;
+    void execute() override;
+    std::optional<lk::Address> _address;
+    std::optional<std::uint64_t> _from;
+    std::optional<std::uint64_t> _count;
+};
+
+
 class FeeInfoCommand final : public Command
 {
   public:
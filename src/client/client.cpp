@@ -59,6 +59,7 @@ std::vector<Command*> Client::initCommands()
     commands.emplace_back(new ShowWalletsCommand{ *this });
     commands.emplace_back(new LastBlockInfoCommand{ *this });
     commands.emplace_back(new AccountInfoCommand{ *this });
+    commands.emplace_back(new AccountTransactionsCommand{ *this });
     commands.emplace_back(new FeeInfoCommand{ *this });
     commands.emplace_back(new SubscribeAccountInfoCommand{ *this });
     commands.emplace_back(new UnsubscribeAccountInfoCommand{ *this });
@@ -27,6 +27,7 @@ class DeleteWalletCommand;
 class ShowWalletsCommand;
 class LastBlockInfoCommand;
 class AccountInfoCommand;
+class AccountTransactionsCommand;
 class FeeInfoCommand;
 class SubscribeAccountInfoCommand;
 class UnsubscribeAccountInfoCommand;
@@ -59,6 +60,7 @@ class Client
     friend ShowWalletsCommand;
     friend LastBlockInfoCommand;
     friend AccountInfoCommand;
+    friend AccountTransactionsCommand;
     friend FeeInfoCommand;
     friend SubscribeAccountInfoCommand;
     friend UnsubscribeAccountInfoCommand;
@@ -66,7 +66,7 @@ bool Address::operator!=(const Address& another) const
 
 bool Address::operator<(const Address& other) const
 {
-    return toString() < other.toString();
+    return _address < other._address;
 }
 
 
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/address.hpp"
+#include "core/bytes_table.hpp"
+
+namespace lk
+{
+
+inline const base::FixedBytes<Address::LENGTH_IN_BYTES>& getKeyBytes(const Address& address) noexcept
+{
+    return address.getBytes();
+}
+
+
+template<typename T>
+using AddressTable = BytesTable<Address, T>;
+
+} // namespace lk
@@ -1,5 +1,6 @@
 #include "block.hpp"
 
+#include "base/assert.hpp"
 #include "base/hash.hpp"
 
 #include <utility>
@@ -19,26 +20,39 @@ ImmutableBlock::ImmutableBlock(lk::BlockDepth depth,
   , _timestamp{ std::move(timestamp) }
   , _coinbase{ std::move(coinbase) }
   , _txs(std::move(txs))
+  , _encoding{ encodeThisBlock() }
   , _this_block_hash{ computeThisBlockHash() }
 {}
 
 
-base::Sha256 ImmutableBlock::computeThisBlockHash()
+base::Sha256 ImmutableBlock::computeThisBlockHash() const
 {
-    base::SerializationOArchive oa;
-    oa.serialize(*this);
-    return base::Sha256::compute(std::move(oa).getBytes());
+    // the transactions are already encoded, so their digest is computed right over the cached encoding
+    base::Sha256Builder transactions_digest;
+    transactions_digest.update(_encoding.bytes->getData() + _encoding.transactions_offset,
+                               _encoding.bytes->size() - _encoding.transactions_offset);
+    return PowHeader{ _depth, _prev_block_hash, _timestamp, _coinbase, transactions_digest.finalize(), _nonce }
+      .computeHash();
 }
 
 
-void ImmutableBlock::serialize(base::SerializationOArchive& oa) const
+ImmutableBlock::Encoding ImmutableBlock::encodeThisBlock() const
 {
+    base::SerializationOArchive oa;
     oa.serialize(_depth);
     oa.serialize(_nonce);
     oa.serialize(_prev_block_hash);
     oa.serialize(_timestamp);
     oa.serialize(_coinbase);
+    auto transactions_offset = oa.getBytes().size();
     oa.serialize(_txs);
+    return { std::make_shared<const base::Bytes>(std::move(oa).getBytes()), transactions_offset };
+}
+
+
+void ImmutableBlock::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serializeRaw(*_encoding.bytes);
 }
 
 
@@ -93,6 +107,18 @@ const lk::Address& ImmutableBlock::getCoinbase() const noexcept
 }
 
 
+const base::Bytes& ImmutableBlock::getSerialized() const noexcept
+{
+    return *_encoding.bytes;
+}
+
+
+base::Bytes ImmutableBlock::getSerializedTransactions() const
+{
+    return _encoding.bytes->takePart(_encoding.transactions_offset, _encoding.bytes->size());
+}
+
+
 const base::Sha256& ImmutableBlock::getHash() const noexcept
 {
     return _this_block_hash;
@@ -214,6 +240,172 @@ void MutableBlock::addTransaction(const Transaction& tx)
 
 //=================================================
 
+BlockHeader::BlockHeader(lk::BlockDepth depth,
+                         NonceInt nonce,
+                         base::Sha256 prev_block_hash,
+                         base::Time timestamp,
+                         lk::Address coinbase,
+                         base::Sha256 block_hash)
+  : _depth{ depth }
+  , _nonce{ nonce }
+  , _prev_block_hash{ std::move(prev_block_hash) }
+  , _timestamp{ std::move(timestamp) }
+  , _coinbase{ std::move(coinbase) }
+  , _block_hash{ std::move(block_hash) }
+{}
+
+
+BlockHeader::BlockHeader(const ImmutableBlock& block)
+  : BlockHeader{ block.getDepth(),     block.getNonce(),    block.getPrevBlockHash(),
+                 block.getTimestamp(), block.getCoinbase(), block.getHash() }
+{}
+
+
+void BlockHeader::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serialize(_depth);
+    oa.serialize(_nonce);
+    oa.serialize(_prev_block_hash);
+    oa.serialize(_timestamp);
+    oa.serialize(_coinbase);
+    oa.serialize(_block_hash);
+}
+
+
+BlockHeader BlockHeader::deserialize(base::SerializationIArchive& ia)
+{
+    auto depth = ia.deserialize<BlockDepth>();
+    auto nonce = ia.deserialize<NonceInt>();
+    auto prev_block_hash = ia.deserialize<base::Sha256>();
+    auto timestamp = ia.deserialize<base::Time>();
+    auto coinbase = ia.deserialize<lk::Address>();
+    auto block_hash = ia.deserialize<base::Sha256>();
+    return { depth,
+             nonce,
+             std::move(prev_block_hash),
+             std::move(timestamp),
+             std::move(coinbase),
+             std::move(block_hash) };
+}
+
+
+lk::BlockDepth BlockHeader::getDepth() const noexcept
+{
+    return _depth;
+}
+
+
+NonceInt BlockHeader::getNonce() const noexcept
+{
+    return _nonce;
+}
+
+
+const base::Sha256& BlockHeader::getPrevBlockHash() const noexcept
+{
+    return _prev_block_hash;
+}
+
+
+const base::Time& BlockHeader::getTimestamp() const noexcept
+{
+    return _timestamp;
+}
+
+
+const lk::Address& BlockHeader::getCoinbase() const noexcept
+{
+    return _coinbase;
+}
+
+
+const base::Sha256& BlockHeader::getHash() const noexcept
+{
+    return _block_hash;
+}
+
+//=================================================
+
+PowHeader::PowHeader(BlockDepth depth,
+                     const base::Sha256& prev_block_hash,
+                     const base::Time& timestamp,
+                     const Address& coinbase,
+                     const base::Sha256& transactions_digest,
+                     NonceInt nonce)
+{
+    base::SerializationOArchive oa;
+    oa.serialize(depth);
+    oa.serialize(prev_block_hash);
+    oa.serialize(timestamp);
+    oa.serialize(coinbase);
+    oa.serialize(transactions_digest);
+    ASSERT(oa.getBytes().size() == NONCE_OFFSET);
+    oa.serialize(nonce);
+    _bytes = base::FixedBytes<SIZE>(oa.getBytes());
+}
+
+
+PowHeader::PowHeader(const MutableBlock& block)
+  : PowHeader{ block.getDepth(),
+               block.getPrevBlockHash(),
+               block.getTimestamp(),
+               block.getCoinbase(),
+               computeTransactionsDigest(block.getTransactions()),
+               block.getNonce() }
+{}
+
+
+const base::FixedBytes<PowHeader::SIZE>& PowHeader::getBytes() const noexcept
+{
+    return _bytes;
+}
+
+
+base::Sha256 PowHeader::computeHash() const
+{
+    return base::Sha256::compute(_bytes);
+}
+
+
+base::Sha256Builder PowHeader::getPrefixHashingState() const
+{
+    base::Sha256Builder state;
+    state.update(_bytes.getData(), NONCE_OFFSET);
+    return state;
+}
+
+
+base::Sha256 PowHeader::computeHash(const base::Sha256Builder& prefix_hashing_state, NonceInt nonce)
+{
+    // same as serialization of the nonce: big-endian
+    auto big_endian_nonce = base::nativeToBig(nonce);
+    auto state = prefix_hashing_state;
+    state.update(reinterpret_cast<const base::Byte*>(&big_endian_nonce), sizeof(big_endian_nonce));
+    return state.finalize();
+}
+
+
+void PowHeader::computeHashes(const base::Sha256Builder& prefix_hashing_state,
+                              NonceInt first_nonce,
+                              HashesBatch& hashes)
+{
+    std::array<NonceInt, HASHES_BATCH_SIZE> big_endian_nonces;
+    std::array<const base::Byte*, HASHES_BATCH_SIZE> suffixes;
+    for (std::size_t i = 0; i < HASHES_BATCH_SIZE; ++i) {
+        big_endian_nonces[i] = base::nativeToBig(static_cast<NonceInt>(first_nonce + i));
+        suffixes[i] = reinterpret_cast<const base::Byte*>(&big_endian_nonces[i]);
+    }
+    prefix_hashing_state.finalizeMany(suffixes.data(), sizeof(NonceInt), HASHES_BATCH_SIZE, hashes.data());
+}
+
+
+base::Sha256 PowHeader::computeTransactionsDigest(const TransactionsSet& txs)
+{
+    return base::Sha256::compute(base::toBytes(txs));
+}
+
+//=================================================
+
 bool operator==(const ImmutableBlock& a, const ImmutableBlock& b)
 {
     return a.getDepth() == b.getDepth() && a.getNonce() == b.getNonce() &&
@@ -8,6 +8,8 @@
 #include "base/hash.hpp"
 #include "base/serialization.hpp"
 
+#include <array>
+#include <memory>
 #include <optional>
 #include <variant>
 
@@ -43,9 +45,21 @@ class ImmutableBlock
     const base::Time& getTimestamp() const noexcept;
     const Address& getCoinbase() const noexcept;
     //=================
+    /*
+     * Canonical encoding of the block. It is computed once at construction and shared between copies,
+     * so serializing a block or computing its hash never goes through its fields again.
+     */
+    const base::Bytes& getSerialized() const noexcept;
+    base::Bytes getSerializedTransactions() const;
     const base::Sha256& getHash() const noexcept;
     //=================
   private:
+    //=================
+    struct Encoding
+    {
+        std::shared_ptr<const base::Bytes> bytes;
+        std::size_t transactions_offset;
+    };
     //=================
     const BlockDepth _depth;
     const NonceInt _nonce;
@@ -54,9 +68,11 @@ class ImmutableBlock
     const Address _coinbase;
     const TransactionsSet _txs;
     //=================
+    const Encoding _encoding;
     const base::Sha256 _this_block_hash;
 
-    base::Sha256 computeThisBlockHash();
+    Encoding encodeThisBlock() const;
+    base::Sha256 computeThisBlockHash() const;
     //=================
 };
 
@@ -107,6 +123,89 @@ class MutableBlock
     //=================
 };
 
+/*
+ * Block fields without transactions. Since a block hash depends on transactions, it is stored with the header.
+ */
+class BlockHeader
+{
+  public:
+    BlockHeader(BlockDepth depth,
+                NonceInt nonce,
+                base::Sha256 prev_block_hash,
+                base::Time timestamp,
+                Address coinbase,
+                base::Sha256 block_hash);
+    explicit BlockHeader(const ImmutableBlock& block);
+
+    BlockHeader(const BlockHeader&) = default;
+    BlockHeader(BlockHeader&&) = default;
+
+    BlockHeader& operator=(const BlockHeader&) = default;
+    BlockHeader& operator=(BlockHeader&&) = default;
+
+    ~BlockHeader() = default;
+    //=================
+    void serialize(base::SerializationOArchive& oa) const;
+    [[nodiscard]] static BlockHeader deserialize(base::SerializationIArchive& ia);
+    //=================
+    BlockDepth getDepth() const noexcept;
+    NonceInt getNonce() const noexcept;
+    const base::Sha256& getPrevBlockHash() const noexcept;
+    const base::Time& getTimestamp() const noexcept;
+    const Address& getCoinbase() const noexcept;
+    const base::Sha256& getHash() const noexcept;
+    //=================
+  private:
+    //=================
+    BlockDepth _depth;
+    NonceInt _nonce;
+    base::Sha256 _prev_block_hash;
+    base::Time _timestamp;
+    Address _coinbase;
+    base::Sha256 _block_hash;
+    //=================
+};
+
+/*
+ * Fixed-size data a block hash is computed from. Transactions are committed by the digest of their encoding and
+ * the nonce is placed at the end, so a miner computes the hashing state of everything before the nonce once
+ * per block template and then hashes only the last 64-byte SHA-256 block for every nonce.
+ */
+class PowHeader
+{
+  public:
+    //=================
+    static constexpr std::size_t NONCE_OFFSET = 96;
+    static constexpr std::size_t SIZE = NONCE_OFFSET + sizeof(NonceInt);
+    //=================
+    PowHeader(BlockDepth depth,
+              const base::Sha256& prev_block_hash,
+              const base::Time& timestamp,
+              const Address& coinbase,
+              const base::Sha256& transactions_digest,
+              NonceInt nonce);
+    explicit PowHeader(const MutableBlock& block);
+    //=================
+    const base::FixedBytes<SIZE>& getBytes() const noexcept;
+    base::Sha256 computeHash() const;
+    //=================
+    base::Sha256Builder getPrefixHashingState() const;
+    static base::Sha256 computeHash(const base::Sha256Builder& prefix_hashing_state, NonceInt nonce);
+
+    // hashes for nonces first_nonce, first_nonce + 1, ... go through the multi-buffer SHA-256 kernel together
+    static constexpr std::size_t HASHES_BATCH_SIZE = 8;
+    using HashesBatch = std::array<base::FixedBytes<base::Sha256::LENGTH>, HASHES_BATCH_SIZE>;
+    static void computeHashes(const base::Sha256Builder& prefix_hashing_state,
+                              NonceInt first_nonce,
+                              HashesBatch& hashes);
+    //=================
+    static base::Sha256 computeTransactionsDigest(const TransactionsSet& txs);
+    //=================
+  private:
+    base::FixedBytes<SIZE> _bytes;
+};
+
+
 bool operator==(const ImmutableBlock& a, const ImmutableBlock& b);
 bool operator!=(const ImmutableBlock& a, const ImmutableBlock& b);
 
@@ -0,0 +1,127 @@
+#include "block_template.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace lk
+{
+
+bool BlockTemplate::Rank::operator<(const Rank& other) const noexcept
+{
+    if (fee != other.fee) {
+        return fee > other.fee;
+    }
+    return arrival < other.arrival;
+}
+
+
+BlockTemplate::BlockTemplate(std::size_t max_transactions_number)
+  : _max_transactions_number{ max_transactions_number }
+  , _fee_value{ 0 }
+{}
+
+
+void BlockTemplate::add(const Transaction& tx)
+{
+    Rank rank{ tx.getFee(), _next_arrival };
+    if (!_transactions.try_emplace(tx.hashOfTransaction(), rank).second) {
+        return;
+    }
+    ++_next_arrival;
+
+    if (_selected.size() < _max_transactions_number) {
+        select(rank, &tx);
+    }
+    else if (!_selected.empty() && rank < std::prev(_selected.end())->first) {
+        unselectWorst();
+        select(rank, &tx);
+    }
+    else {
+        _candidates.emplace(rank, &tx);
+    }
+}
+
+
+void BlockTemplate::remove(const Transaction& tx)
+{
+    auto it = _transactions.find(tx.hashOfTransaction());
+    if (it == _transactions.end()) {
+        return;
+    }
+    const auto rank = it->second;
+
+    if (auto selected_it = _selected.find(rank); selected_it != _selected.end()) {
+        _fee_value -= rank.fee;
+        _selected.erase(selected_it);
+        if (!_candidates.empty()) {
+            auto best_candidate = _candidates.begin();
+            select(best_candidate->first, best_candidate->second);
+            _candidates.erase(best_candidate);
+        }
+    }
+    else {
+        _candidates.erase(rank);
+    }
+    _transactions.erase(it);
+}
+
+
+void BlockTemplate::remove(const TransactionsSet& txs)
+{
+    for (const auto& tx : txs) {
+        remove(tx);
+    }
+}
+
+
+TransactionsSet BlockTemplate::getTransactions() const
+{
+    std::vector<std::pair<std::uint64_t, const Transaction*>> selected;
+    selected.reserve(_selected.size());
+    for (const auto& [rank, tx] : _selected) {
+        selected.emplace_back(rank.arrival, tx);
+    }
+    std::sort(selected.begin(), selected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    TransactionsSet ret;
+    for (const auto& [arrival, tx] : selected) {
+        ret.add(*tx);
+    }
+    return ret;
+}
+
+
+const Balance& BlockTemplate::getFeeValue() const noexcept
+{
+    return _fee_value;
+}
+
+
+std::size_t BlockTemplate::getSelectedNumber() const noexcept
+{
+    return _selected.size();
+}
+
+
+std::size_t BlockTemplate::size() const noexcept
+{
+    return _transactions.size();
+}
+
+
+void BlockTemplate::select(const Rank& rank, const Transaction* tx)
+{
+    _selected.emplace(rank, tx);
+    _fee_value += rank.fee;
+}
+
+
+void BlockTemplate::unselectWorst()
+{
+    auto worst = std::prev(_selected.end());
+    _fee_value -= worst->first.fee;
+    _candidates.emplace(worst->first, worst->second);
+    _selected.erase(worst);
+}
+
+} // namespace lk
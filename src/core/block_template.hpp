@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/transaction.hpp"
+#include "core/transactions_set.hpp"
+#include "core/types.hpp"
+
+#include <map>
+#include <unordered_map>
+
+namespace lk
+{
+
+/*
+ * The best by fee subset of pending transactions that fits into a block. It is kept up to date on every addition
+ * and removal, so building a mining job doesn't need to copy and sort all the pending transactions.
+ * Among equal fees an earlier transaction wins, and selected transactions are given in the order they arrived.
+ * The template doesn't own transactions: an added transaction must stay alive until it is removed.
+ */
+class BlockTemplate
+{
+  public:
+    //=================
+    explicit BlockTemplate(std::size_t max_transactions_number);
+    BlockTemplate(const BlockTemplate&) = delete;
+    BlockTemplate& operator=(const BlockTemplate&) = delete;
+    ~BlockTemplate() = default;
+    //=================
+    void add(const Transaction& tx);
+    void remove(const Transaction& tx);
+    void remove(const TransactionsSet& txs);
+    //=================
+    TransactionsSet getTransactions() const;
+    const Balance& getFeeValue() const noexcept; // sum of fees of selected transactions
+    std::size_t getSelectedNumber() const noexcept;
+    std::size_t size() const noexcept; // of all known transactions, selected or not
+    //=================
+  private:
+    struct Rank
+    {
+        Fee fee;
+        std::uint64_t arrival;
+        //=================
+        bool operator<(const Rank& other) const noexcept; // better transactions go first
+    };
+    //=================
+    const std::size_t _max_transactions_number;
+    std::uint64_t _next_arrival{ 0 };
+    std::unordered_map<base::Sha256, Rank> _transactions;
+    std::map<Rank, const Transaction*> _selected;
+    std::map<Rank, const Transaction*> _candidates;
+    Balance _fee_value;
+    //=================
+    void select(const Rank& rank, const Transaction* tx);
+    void unselectWorst();
+    //=================
+};
+
+} // namespace lk
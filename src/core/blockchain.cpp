@@ -2,9 +2,18 @@
 
 #include "base/assert.hpp"
 #include "base/log.hpp"
+#include "base/time.hpp"
 
 #include "core/consensus.hpp"
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
 #include <optional>
 
 namespace
@@ -13,8 +22,14 @@ namespace
 enum class DataType
 {
     SYSTEM = 1,
-    BLOCK = 2,
-    PREVIOUS_BLOCK_HASH = 3
+    // 2 and 3 were used by whole-block records of the previous storage format
+    TRANSACTION_LOCATION = 4,
+    BLOCK_HEADER = 5,
+    BLOCK_BODY = 6,
+    BLOCK_HASH_BY_DEPTH = 7,
+    TRANSACTION_STATUS = 8,
+    ACCOUNT_TRANSACTION = 9,
+    CONTRACT_CODE = 10
 };
 
 
@@ -37,7 +52,43 @@ base::Bytes toBytes(DataType type, const base::FixedBytes<S>& key)
 }
 
 
+base::Bytes toBytes(DataType type, lk::BlockDepth depth)
+{
+    return toBytes(type, base::toBytes(depth));
+}
+
+
+base::Bytes toBytes(DataType type, const lk::Address& address, std::uint64_t sequence_number)
+{
+    auto key = toBytes(type, address.getBytes());
+    key.append(base::toBytes(sequence_number));
+    return key;
+}
+
+
 const base::Bytes LAST_BLOCK_HASH_KEY{ toBytes(DataType::SYSTEM, base::Bytes("last_block_hash")) };
+// snapshots under previous keys have another format of accounts, so they are ignored and the state is replayed
+const base::Bytes STATE_SNAPSHOT_KEY{ toBytes(DataType::SYSTEM, base::Bytes("state_snapshot_v3")) };
+
+
+std::size_t getBlocksCacheBytes(base::json::Value& config)
+{
+    if (config.has_number_field("blocks_cache_bytes")) {
+        auto cache_bytes_value = config["blocks_cache_bytes"].as_number();
+        if (cache_bytes_value.is_uint64() && cache_bytes_value.to_uint64() > 0) {
+            return cache_bytes_value.to_uint64();
+        }
+        RAISE_ERROR(base::InvalidArgument, "database \"blocks_cache_bytes\" must be a positive integer");
+    }
+    return base::config::DATABASE_BLOCKS_CACHE_BYTES;
+}
+
+
+std::size_t getCachedBlockWeight(const lk::ImmutableBlock& block)
+{
+    // a block keeps its encoding, so the cache is bounded by the encoded size of blocks
+    return block.getSerialized().size();
+}
 
 } // namespace
 
@@ -45,8 +96,41 @@ const base::Bytes LAST_BLOCK_HASH_KEY{ toBytes(DataType::SYSTEM, base::Bytes("la
 namespace lk
 {
 
-Blockchain::Blockchain(ImmutableBlock genesis_block)
-  : _genesis_block_hash{ base::Sha256::null() }
+void TransactionLocation::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serialize(block_hash);
+    oa.serialize(index_in_block);
+}
+
+
+TransactionLocation TransactionLocation::deserialize(base::SerializationIArchive& ia)
+{
+    auto block_hash = ia.deserialize<base::Sha256>();
+    auto index_in_block = ia.deserialize<std::size_t>();
+    return { block_hash, index_in_block };
+}
+
+
+void StateSnapshot::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serialize(depth);
+    oa.serialize(block_hash);
+    oa.serialize(state);
+}
+
+
+StateSnapshot StateSnapshot::deserialize(base::SerializationIArchive& ia)
+{
+    auto depth = ia.deserialize<BlockDepth>();
+    auto block_hash = ia.deserialize<base::Sha256>();
+    auto state = ia.deserialize<base::Bytes>();
+    return { depth, std::move(block_hash), std::move(state) };
+}
+
+
+Blockchain::Blockchain(ImmutableBlock genesis_block, std::size_t blocks_cache_bytes)
+  : _blocks_cache{ blocks_cache_bytes }
+  , _genesis_block_hash{ base::Sha256::null() }
   , _top_level_block_hash{ base::Sha256::null() }
 // temporary null, because it requires initialization. Set to real value in addGenesisBlock
 {
@@ -59,16 +143,19 @@ void Blockchain::addGenesisBlock(ImmutableBlock block)
     const auto hash = block.getHash();
 
     std::lock_guard lk(_blocks_mutex);
-    if (!_blocks.empty()) {
+    if (!_blocks_by_depth.empty()) {
         RAISE_ERROR(base::LogicError, "cannot add genesis to non-empty chain");
     }
 
-    auto inserted_block = _blocks.insert({ hash, std::move(block) }).first;
+    auto inserted_block = std::make_shared<const ImmutableBlock>(std::move(block));
+    _blocks_cache.put(hash, inserted_block, getCachedBlockWeight(*inserted_block));
     _blocks_by_depth.insert({ 0, hash });
+    _indexBlockTransactions(*inserted_block);
+    _genesis_block = _top_block = inserted_block;
     _top_level_block_hash = _genesis_block_hash = hash;
 
     LOG_DEBUG << "Adding genesis block. Block hash = " << hash;
-    _block_added.notify(inserted_block->second);
+    _block_added.notify(*inserted_block);
 }
 
 
@@ -76,25 +163,22 @@ Blockchain::AdditionResult Blockchain::tryAddBlock(const ImmutableBlock& block)
 {
     const auto hash = block.getHash();
 
-    decltype(_blocks)::iterator inserted_block;
+    std::shared_ptr<const ImmutableBlock> inserted_block;
     {
         std::lock_guard lk(_blocks_mutex);
 
-        if (!_blocks.empty() && _blocks.find(hash) != _blocks.end()) {
+        if (_isInChain(block.getDepth(), hash)) {
             return AdditionResult::ALREADY_IN_BLOCKCHAIN;
         }
-        else if (!_blocks.empty() && _top_level_block_hash != block.getPrevBlockHash()) {
+        else if (_top_level_block_hash != block.getPrevBlockHash()) {
             return AdditionResult::INVALID_PARENT_HASH;
         }
-        else if (_blocks.size() != block.getDepth()) {
+        else if (_blocks_by_depth.size() != block.getDepth()) {
             return AdditionResult::INVALID_DEPTH;
         }
         else if (!checkConsensus(block)) {
             return AdditionResult::CONSENSUS_ERROR;
         }
-        else if (_top_level_block_hash != block.getPrevBlockHash()) {
-            return AdditionResult::INVALID_PARENT_HASH;
-        }
         else if (block.getTransactions().size() == 0 ||
                  block.getTransactions().size() > base::config::BC_MAX_TRANSACTIONS_IN_BLOCK) {
             return AdditionResult::INVALID_TRANSACTIONS_NUMBER;
@@ -109,15 +193,42 @@ Blockchain::AdditionResult Blockchain::tryAddBlock(const ImmutableBlock& block)
 
         // if here, this means that the block is ok
         LOG_DEBUG << "Complexity right now is: " << _consensus.getComplexity().getDensed();
-        _consensus.applyBlock(block);
+        _consensus.applyBlock(BlockHeader{ block });
 
-        inserted_block = _blocks.insert({ hash, block }).first;
-        _blocks_by_depth.insert({ block.getDepth(), hash });
-        _top_level_block_hash = hash;
+        inserted_block = std::make_shared<const ImmutableBlock>(block);
+        _indexBlockTransactions(*inserted_block);
+        _appendBlock(inserted_block);
     }
 
     LOG_DEBUG << "Block " << hash << " has been added to blockchain";
-    _block_added.notify(inserted_block->second);
+    _block_added.notify(*inserted_block);
+
+    return AdditionResult::ADDED;
+}
+
+
+Blockchain::AdditionResult Blockchain::addTrustedBlock(ImmutableBlock block,
+                                                       const std::vector<base::Sha256>& transactions_hashes)
+{
+    std::shared_ptr<const ImmutableBlock> inserted_block;
+    {
+        std::lock_guard lk(_blocks_mutex);
+
+        if (_top_level_block_hash != block.getPrevBlockHash()) {
+            return AdditionResult::INVALID_PARENT_HASH;
+        }
+        else if (_blocks_by_depth.size() != block.getDepth()) {
+            return AdditionResult::INVALID_DEPTH;
+        }
+
+        _consensus.applyBlock(BlockHeader{ block });
+
+        inserted_block = std::make_shared<const ImmutableBlock>(std::move(block));
+        _indexBlockTransactions(*inserted_block, transactions_hashes);
+        _appendBlock(inserted_block);
+    }
+
+    _block_added.notify(*inserted_block);
 
     return AdditionResult::ADDED;
 }
@@ -126,8 +237,8 @@ Blockchain::AdditionResult Blockchain::tryAddBlock(const ImmutableBlock& block)
 std::optional<ImmutableBlock> Blockchain::findBlock(const base::Sha256& block_hash) const
 {
     std::shared_lock lk(_blocks_mutex);
-    if (auto it = _blocks.find(block_hash); it != _blocks.end()) {
-        return it->second;
+    if (auto block = _findBlock(block_hash)) {
+        return *block;
     }
     else {
         return std::nullopt;
@@ -135,6 +246,13 @@ std::optional<ImmutableBlock> Blockchain::findBlock(const base::Sha256& block_ha
 }
 
 
+std::optional<BlockHeader> Blockchain::findBlockHeader(const base::Sha256& block_hash) const
+{
+    std::shared_lock lk(_blocks_mutex);
+    return _findBlockHeader(block_hash);
+}
+
+
 std::optional<base::Sha256> Blockchain::findBlockHashByDepth(lk::BlockDepth depth) const
 {
     std::shared_lock lk(_blocks_mutex);
@@ -150,29 +268,32 @@ std::optional<base::Sha256> Blockchain::findBlockHashByDepth(lk::BlockDepth dept
 std::optional<lk::Transaction> Blockchain::findTransaction(const base::Sha256& tx_hash) const
 {
     std::shared_lock lk(_blocks_mutex);
-    for (const auto& block : _blocks) {
-        for (const auto& tx : block.second.getTransactions()) {
-            if (tx.hashOfTransaction() == tx_hash) {
-                return tx;
-            }
-        }
+    auto location = _transactions_index.find(tx_hash);
+    if (location == _transactions_index.end()) {
+        return std::nullopt;
     }
-    return std::nullopt;
+
+    auto block = _findBlock(location->second.block_hash);
+    if (!block) {
+        return std::nullopt;
+    }
+    const auto& txs = block->getTransactions();
+    ASSERT(location->second.index_in_block < txs.size());
+    return *std::next(txs.begin(), location->second.index_in_block);
 }
 
 
 ImmutableBlock Blockchain::getGenesisBlock() const
 {
-    auto block = findBlock(_genesis_block_hash);
-    ASSERT(block);
-    return *block;
+    std::shared_lock lk(_blocks_mutex);
+    return *_genesis_block;
 }
 
 
 std::pair<ImmutableBlock, lk::Complexity> Blockchain::getTopBlockAndComplexity() const
 {
     std::shared_lock lk(_blocks_mutex);
-    return { getTopBlock(), _consensus.getComplexity() };
+    return { _getTopBlock(), _consensus.getComplexity() };
 }
 
 
@@ -186,18 +307,125 @@ ImmutableBlock Blockchain::getTopBlock() const
 const ImmutableBlock& Blockchain::_getTopBlock() const
 {
     ASSERT(!_blocks_mutex.try_lock()); // ensures that this function is used only in thread-safe environment
-    auto it = _blocks.find(_top_level_block_hash);
-    ASSERT(it != _blocks.end());
-    return it->second;
+    ASSERT(_top_block);
+    return *_top_block;
+}
+
+
+std::shared_ptr<const ImmutableBlock> Blockchain::_findBlock(const base::Sha256& block_hash) const
+{
+    if (block_hash == _top_level_block_hash) {
+        return _top_block;
+    }
+    else if (block_hash == _genesis_block_hash) {
+        return _genesis_block;
+    }
+    else if (auto cached = _blocks_cache.find(block_hash)) {
+        return *cached;
+    }
+
+    auto block = findEvictedBlock(block_hash);
+    if (!block) {
+        return nullptr;
+    }
+
+    // storage may contain blocks that are not a part of this chain, so they are not cached and returned
+    if (!_isInChain(block->getDepth(), block_hash)) {
+        return nullptr;
+    }
+
+    auto loaded_block = std::make_shared<const ImmutableBlock>(std::move(*block));
+    _blocks_cache.put(block_hash, loaded_block, getCachedBlockWeight(*loaded_block));
+    return loaded_block;
+}
+
+
+std::optional<BlockHeader> Blockchain::_findBlockHeader(const base::Sha256& block_hash) const
+{
+    if (block_hash == _top_level_block_hash) {
+        return BlockHeader{ *_top_block };
+    }
+    else if (block_hash == _genesis_block_hash) {
+        return BlockHeader{ *_genesis_block };
+    }
+    else if (auto cached = _blocks_cache.find(block_hash)) {
+        return BlockHeader{ **cached };
+    }
+
+    auto header = findEvictedBlockHeader(block_hash);
+    if (!header || !_isInChain(header->getDepth(), block_hash)) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+
+bool Blockchain::_isInChain(lk::BlockDepth depth, const base::Sha256& block_hash) const
+{
+    auto it = _blocks_by_depth.find(depth);
+    return it != _blocks_by_depth.end() && it->second == block_hash;
+}
+
+
+std::optional<ImmutableBlock> Blockchain::findEvictedBlock(const base::Sha256&) const
+{
+    return std::nullopt;
+}
+
+
+std::optional<BlockHeader> Blockchain::findEvictedBlockHeader(const base::Sha256&) const
+{
+    return std::nullopt;
+}
+
+
+void Blockchain::_appendBlock(std::shared_ptr<const ImmutableBlock> block)
+{
+    ASSERT(!_blocks_mutex.try_lock()); // ensures that this function is used only in thread-safe environment
+    const auto& hash = block->getHash();
+    _blocks_cache.put(hash, block, getCachedBlockWeight(*block));
+    _blocks_by_depth.insert({ block->getDepth(), hash });
+    _top_level_block_hash = hash;
+    _top_block = std::move(block);
+}
+
+
+void Blockchain::_indexBlockTransactions(const ImmutableBlock& block)
+{
+    std::vector<base::Sha256> transactions_hashes;
+    transactions_hashes.reserve(block.getTransactions().size());
+    for (const auto& tx : block.getTransactions()) {
+        transactions_hashes.push_back(tx.hashOfTransaction());
+    }
+    _indexBlockTransactions(block, transactions_hashes);
+}
+
+
+void Blockchain::_indexBlockTransactions(const ImmutableBlock& block,
+                                         const std::vector<base::Sha256>& transactions_hashes)
+{
+    ASSERT(!_blocks_mutex.try_lock()); // ensures that this function is used only in thread-safe environment
+    ASSERT(transactions_hashes.size() == block.getTransactions().size());
+    for (std::size_t index_in_block = 0; index_in_block < transactions_hashes.size(); ++index_in_block) {
+        _transactions_index.insert(
+          { transactions_hashes[index_in_block], TransactionLocation{ block.getHash(), index_in_block } });
+    }
 }
 
 
 base::Sha256 Blockchain::getTopBlockHash() const
 {
+    std::shared_lock lk(_blocks_mutex);
     return _top_level_block_hash;
 }
 
 
+Blockchain::BlocksCacheStats Blockchain::getBlocksCacheStats() const
+{
+    return _blocks_cache.getStats();
+}
+
+
 bool Blockchain::checkConsensus(const ImmutableBlock& block) const
 {
     return _consensus.checkBlock(block);
@@ -205,7 +433,7 @@ bool Blockchain::checkConsensus(const ImmutableBlock& block) const
 
 
 PersistentBlockchain::PersistentBlockchain(ImmutableBlock genesis_block, base::json::Value config)
-  : Blockchain{ std::move(genesis_block) }
+  : Blockchain{ std::move(genesis_block), getBlocksCacheBytes(config) }
 {
     std::string database_path{ config["path"].as_string() };
     if (config["clean"].as_bool()) {
@@ -219,43 +447,299 @@ PersistentBlockchain::PersistentBlockchain(ImmutableBlock genesis_block, base::j
 }
 
 
-void PersistentBlockchain::load()
+PersistentBlockchain::LoadingStats PersistentBlockchain::load()
 {
-    for (const auto& block_hash : createAllBlockHashesListAtPersistentStorage()) {
-        LOG_DEBUG << "Loading block " << block_hash << " from database";
-        auto current_block = findBlockAtPersistentStorage(block_hash);
-        ASSERT(current_block);
-        tryAddBlock(current_block.value());
+    base::Timer timer;
+    timer.start();
+
+    lk::BlockDepth top_depth = 0;
+    if (auto last_block_hash = getLastBlockHashAtPersistentStorage()) {
+        auto last_block_header = findBlockHeaderAtPersistentStorage(last_block_hash.value());
+        if (!last_block_header) {
+            RAISE_ERROR(base::DatabaseError, "database has unsupported format and must be cleaned");
+        }
+        top_depth = last_block_header->getDepth();
+    }
+    // blocks with depths from 1 to top_depth are loaded, the genesis block is never stored
+    const std::size_t blocks_count = top_depth;
+
+    struct LoadedBlock
+    {
+        std::optional<base::Sha256> expected_hash;
+        std::optional<ImmutableBlock> block;
+        std::vector<base::Sha256> transactions_hashes;
+        bool is_ready{ false };
+    };
+    std::vector<LoadedBlock> loaded_blocks(blocks_count);
+    std::size_t applied_count = 0;
+    bool is_stopped = false;
+    std::mutex loading_mutex;
+    std::condition_variable loading_cv;
+
+    boost::asio::thread_pool workers{ std::max(1u, std::thread::hardware_concurrency()) };
+
+    auto complete_loading = [&](std::size_t index,
+                                std::optional<base::Sha256> hash,
+                                std::optional<ImmutableBlock> block) {
+        std::vector<base::Sha256> transactions_hashes;
+        if (block) {
+            transactions_hashes.reserve(block->getTransactions().size());
+            for (const auto& tx : block->getTransactions()) {
+                transactions_hashes.push_back(tx.hashOfTransaction());
+            }
+        }
+        {
+            std::lock_guard lk(loading_mutex);
+            loaded_blocks[index].expected_hash = std::move(hash);
+            if (block) {
+                loaded_blocks[index].block.emplace(std::move(block.value()));
+            }
+            loaded_blocks[index].transactions_hashes = std::move(transactions_hashes);
+            loaded_blocks[index].is_ready = true;
+        }
+        loading_cv.notify_all();
+    };
+
+    // prefetching stage: follows the depth index and reads raw headers and bodies in order,
+    // keeping at most DATABASE_LOADING_WINDOW blocks in flight
+    std::thread prefetcher([&] {
+        for (std::size_t index = 0; index < blocks_count; ++index) {
+            {
+                std::unique_lock lk(loading_mutex);
+                loading_cv.wait(lk, [&] {
+                    return is_stopped || index < applied_count + base::config::DATABASE_LOADING_WINDOW;
+                });
+                if (is_stopped) {
+                    return;
+                }
+            }
+
+            std::optional<base::Sha256> block_hash;
+            std::optional<base::Bytes> header_data;
+            std::optional<base::Bytes> body_data;
+            try {
+                block_hash = findBlockHashByDepthAtPersistentStorage(index + 1);
+                if (block_hash) {
+                    std::shared_lock lk(_database_rw_mutex);
+                    header_data = _database.get(toBytes(DataType::BLOCK_HEADER, block_hash->getBytes()));
+                    body_data = _database.get(toBytes(DataType::BLOCK_BODY, block_hash->getBytes()));
+                }
+            }
+            catch (const std::exception& e) {
+                LOG_ERROR << "Failed to read block #" << index + 1 << ": " << e.what();
+            }
+            if (!header_data || !body_data) {
+                complete_loading(index, std::move(block_hash), std::nullopt);
+                continue;
+            }
+
+            // deserialization stage: ImmutableBlock computes its hash during construction
+            boost::asio::post(workers,
+                              [&,
+                               index,
+                               block_hash = std::move(block_hash),
+                               header_data = std::move(header_data.value()),
+                               body_data = std::move(body_data.value())] {
+                                  std::optional<ImmutableBlock> block;
+                                  try {
+                                      auto header = base::fromBytes<BlockHeader>(header_data);
+                                      block.emplace(header.getDepth(),
+                                                    header.getNonce(),
+                                                    header.getPrevBlockHash(),
+                                                    header.getTimestamp(),
+                                                    header.getCoinbase(),
+                                                    base::fromBytes<TransactionsSet>(body_data));
+                                  }
+                                  catch (const std::exception& e) {
+                                      LOG_ERROR << "Failed to deserialize block #" << index + 1 << ": " << e.what();
+                                  }
+                                  complete_loading(index, block_hash, std::move(block));
+                              });
+        }
+    });
+
+    auto stop_loading = [&] {
+        {
+            std::lock_guard lk(loading_mutex);
+            is_stopped = true;
+        }
+        loading_cv.notify_all();
+        prefetcher.join();
+        workers.join();
+    };
+
+    // apply stage: blocks are added strictly in order
+    try {
+        for (std::size_t index = 0; index < blocks_count; ++index) {
+            std::unique_lock lk(loading_mutex);
+            loading_cv.wait(lk, [&] { return loaded_blocks[index].is_ready; });
+            LoadedBlock current{ std::move(loaded_blocks[index]) };
+            loaded_blocks[index].block.reset();
+            lk.unlock();
+
+            if (!current.expected_hash || !current.block || current.block->getHash() != current.expected_hash) {
+                RAISE_ERROR(base::DatabaseError,
+                            "database contains corrupted block #" + std::to_string(index + 1));
+            }
+
+            LOG_DEBUG << "Loading block " << current.block->getHash() << " from database";
+            if (auto r = addTrustedBlock(std::move(current.block.value()), current.transactions_hashes);
+                r != AdditionResult::ADDED) {
+                RAISE_ERROR(base::DatabaseError,
+                            "cannot load block #" + std::to_string(index + 1) + " with reason " +
+                              std::to_string(static_cast<int>(r)));
+            }
+
+            lk.lock();
+            ++applied_count;
+            lk.unlock();
+            loading_cv.notify_all();
+        }
     }
+    catch (...) {
+        stop_loading();
+        throw;
+    }
+    stop_loading();
+
+    LoadingStats stats{ blocks_count, timer.elapsedMillis() };
+    LOG_INFO << "Loaded " << stats.blocks_count << " blocks from database in " << stats.elapsed_millis << " ms";
+    return stats;
 }
 
 
-IBlockchain::AdditionResult PersistentBlockchain::tryAddBlock(const ImmutableBlock& block)
+std::optional<Transaction> PersistentBlockchain::findTransaction(const base::Sha256& tx_hash) const
 {
-    auto r = Blockchain::tryAddBlock(block);
-    if (r == IBlockchain::AdditionResult::ADDED) {
-        pushForwardToPersistentStorage(block);
+    if (auto tx = Blockchain::findTransaction(tx_hash)) {
+        return tx;
     }
-    else {
-        LOG_DEBUG << block.getHash() << " is not added with reason " << static_cast<int>(r);
+
+    auto location = findTransactionLocationAtPersistentStorage(tx_hash);
+    if (!location) {
+        return std::nullopt;
+    }
+
+    auto transactions = findBlockBodyAtPersistentStorage(location->block_hash);
+    if (!transactions || location->index_in_block >= transactions->size()) {
+        return std::nullopt;
     }
-    return r;
+    return *std::next(transactions->begin(), location->index_in_block);
 }
 
 
-void PersistentBlockchain::pushForwardToPersistentStorage(const ImmutableBlock& block)
+void PersistentBlockchain::pushForwardToPersistentStorage(const ImmutableBlock& block, const BlockOutputs& outputs)
 {
     const auto raw_block_hash = block.getHash().getBytes();
-    auto serialized_block = base::toBytes(block);
+
+    base::Database::WriteBatch batch;
+    batch.put(toBytes(DataType::BLOCK_HEADER, raw_block_hash), base::toBytes(BlockHeader{ block }));
+    batch.put(toBytes(DataType::BLOCK_BODY, raw_block_hash), block.getSerializedTransactions());
+    batch.put(toBytes(DataType::BLOCK_HASH_BY_DEPTH, block.getDepth()), raw_block_hash);
+
+    std::size_t index_in_block = 0;
+    for (const auto& tx : block.getTransactions()) {
+        batch.put(toBytes(DataType::TRANSACTION_LOCATION, tx.hashOfTransaction().getBytes()),
+                  base::toBytes(TransactionLocation{ block.getHash(), index_in_block }));
+        ++index_in_block;
+    }
+
+    for (const auto& [tx_hash, status] : outputs.statuses) {
+        batch.put(toBytes(DataType::TRANSACTION_STATUS, tx_hash.getBytes()), base::toBytes(status));
+    }
+    for (const auto& [address, sequence_number, tx_hash] : outputs.accounts_transactions) {
+        batch.put(toBytes(DataType::ACCOUNT_TRANSACTION, address, sequence_number), tx_hash.getBytes());
+    }
+    for (const auto& [code_hash, code] : outputs.contracts_code) {
+        batch.put(toBytes(DataType::CONTRACT_CODE, code_hash.getBytes()), *code);
+    }
+
+    batch.put(LAST_BLOCK_HASH_KEY, raw_block_hash);
+
     {
         std::lock_guard lk(_database_rw_mutex);
-        if (_database.exists(toBytes(DataType::BLOCK, raw_block_hash))) {
-            return;
+        _database.write(std::move(batch));
+    }
+}
+
+
+std::optional<TransactionStatus> PersistentBlockchain::findTransactionStatus(const base::Sha256& tx_hash) const
+{
+    std::shared_lock lk(_database_rw_mutex);
+    auto status_data = _database.get(toBytes(DataType::TRANSACTION_STATUS, tx_hash.getBytes()));
+    if (!status_data) {
+        return std::nullopt;
+    }
+    return base::fromBytes<TransactionStatus>(status_data.value());
+}
+
+
+std::vector<base::Sha256> PersistentBlockchain::findAccountTransactions(const lk::Address& address,
+                                                                        std::uint64_t first_sequence_number,
+                                                                        std::size_t count) const
+{
+    std::vector<base::Sha256> ret;
+    ret.reserve(count);
+
+    std::shared_lock lk(_database_rw_mutex);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto hash_data = _database.get(toBytes(DataType::ACCOUNT_TRANSACTION, address, first_sequence_number + i));
+        if (!hash_data) {
+            // sequence numbers are contiguous, so the end of the history is reached
+            break;
         }
-        _database.put(toBytes(DataType::BLOCK, raw_block_hash), serialized_block);
-        _database.put(toBytes(DataType::PREVIOUS_BLOCK_HASH, raw_block_hash), block.getPrevBlockHash().getBytes());
-        _database.put(LAST_BLOCK_HASH_KEY, raw_block_hash);
+        ret.emplace_back(std::move(hash_data.value()));
+    }
+    return ret;
+}
+
+
+void PersistentBlockchain::saveStateSnapshot(const StateSnapshot& snapshot)
+{
+    auto serialized_snapshot = base::toBytes(snapshot);
+    {
+        std::lock_guard lk(_database_rw_mutex);
+        _database.put(STATE_SNAPSHOT_KEY, serialized_snapshot);
+    }
+    LOG_DEBUG << "Saved state snapshot at block #" << snapshot.depth;
+}
+
+
+std::optional<base::Bytes> PersistentBlockchain::findContractCode(const base::Sha256& code_hash) const
+{
+    std::shared_lock lk(_database_rw_mutex);
+    return _database.get(toBytes(DataType::CONTRACT_CODE, code_hash.getBytes()));
+}
+
+
+std::optional<StateSnapshot> PersistentBlockchain::loadStateSnapshot() const
+{
+    std::optional<base::Bytes> snapshot_data;
+    {
+        std::shared_lock lk(_database_rw_mutex);
+        snapshot_data = _database.get(STATE_SNAPSHOT_KEY);
+    }
+    if (!snapshot_data) {
+        return std::nullopt;
     }
+
+    auto snapshot = base::fromBytes<StateSnapshot>(snapshot_data.value());
+    if (findBlockHashByDepth(snapshot.depth) != snapshot.block_hash) {
+        LOG_WARNING << "State snapshot at block #" << snapshot.depth << " doesn't belong to the loaded chain";
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+
+std::optional<ImmutableBlock> PersistentBlockchain::findEvictedBlock(const base::Sha256& block_hash) const
+{
+    return findBlockAtPersistentStorage(block_hash);
+}
+
+
+std::optional<BlockHeader> PersistentBlockchain::findEvictedBlockHeader(const base::Sha256& block_hash) const
+{
+    return findBlockHeaderAtPersistentStorage(block_hash);
 }
 
 
@@ -271,38 +755,65 @@ std::optional<base::Sha256> PersistentBlockchain::getLastBlockHashAtPersistentSt
 }
 
 
-std::optional<ImmutableBlock> PersistentBlockchain::findBlockAtPersistentStorage(const base::Sha256& block_hash) const
+std::optional<base::Sha256> PersistentBlockchain::findBlockHashByDepthAtPersistentStorage(lk::BlockDepth depth) const
 {
     std::shared_lock lk(_database_rw_mutex);
-    auto block_data = _database.get(toBytes(DataType::BLOCK, block_hash.getBytes()));
-    if (!block_data) {
+    auto hash_data = _database.get(toBytes(DataType::BLOCK_HASH_BY_DEPTH, depth));
+    if (!hash_data) {
         return std::nullopt;
     }
-    base::SerializationIArchive ia(block_data.value());
-    return ia.deserialize<ImmutableBlock>();
+    return base::Sha256(std::move(hash_data.value()));
 }
 
 
-std::vector<base::Sha256> PersistentBlockchain::createAllBlockHashesListAtPersistentStorage() const
+std::optional<BlockHeader> PersistentBlockchain::findBlockHeaderAtPersistentStorage(
+  const base::Sha256& block_hash) const
 {
-    std::vector<base::Sha256> all_blocks_hashes{};
-    auto last_block_hash = getLastBlockHashAtPersistentStorage();
-    if (last_block_hash) {
-        base::Sha256 current_block_hash = last_block_hash.value();
-        const base::Sha256 genesis_hash = getGenesisBlock().getHash();
+    std::shared_lock lk(_database_rw_mutex);
+    auto header_data = _database.get(toBytes(DataType::BLOCK_HEADER, block_hash.getBytes()));
+    if (!header_data) {
+        return std::nullopt;
+    }
+    return base::fromBytes<BlockHeader>(header_data.value());
+}
 
-        std::shared_lock lk(_database_rw_mutex);
-        while (current_block_hash != genesis_hash) {
-            all_blocks_hashes.push_back(current_block_hash);
-            auto previous_block_hash_data =
-              _database.get(toBytes(DataType::PREVIOUS_BLOCK_HASH, current_block_hash.getBytes()));
-            ASSERT(previous_block_hash_data);
-            current_block_hash = base::Sha256(std::move(previous_block_hash_data.value()));
-        }
 
-        std::reverse(std::begin(all_blocks_hashes), std::end(all_blocks_hashes));
+std::optional<TransactionsSet> PersistentBlockchain::findBlockBodyAtPersistentStorage(
+  const base::Sha256& block_hash) const
+{
+    std::shared_lock lk(_database_rw_mutex);
+    auto body_data = _database.get(toBytes(DataType::BLOCK_BODY, block_hash.getBytes()));
+    if (!body_data) {
+        return std::nullopt;
+    }
+    return base::fromBytes<TransactionsSet>(body_data.value());
+}
+
+
+std::optional<ImmutableBlock> PersistentBlockchain::findBlockAtPersistentStorage(const base::Sha256& block_hash) const
+{
+    auto header = findBlockHeaderAtPersistentStorage(block_hash);
+    if (!header) {
+        return std::nullopt;
+    }
+    auto transactions = findBlockBodyAtPersistentStorage(block_hash);
+    if (!transactions) {
+        return std::nullopt;
+    }
+    return ImmutableBlock{ header->getDepth(),     header->getNonce(),    header->getPrevBlockHash(),
+                           header->getTimestamp(), header->getCoinbase(), std::move(transactions.value()) };
+}
+
+
+std::optional<TransactionLocation> PersistentBlockchain::findTransactionLocationAtPersistentStorage(
+  const base::Sha256& tx_hash) const
+{
+    std::shared_lock lk(_database_rw_mutex);
+    auto location_data = _database.get(toBytes(DataType::TRANSACTION_LOCATION, tx_hash.getBytes()));
+    if (!location_data) {
+        return std::nullopt;
     }
-    return all_blocks_hashes;
+    return base::fromBytes<TransactionLocation>(location_data.value());
 }
 
 } // namespace lk
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/block.hpp"
+#include "core/code_store.hpp"
 #include "core/consensus.hpp"
 #include "core/transaction.hpp"
 #include "core/transactions_set.hpp"
@@ -9,12 +10,60 @@
 #include "base/json.hpp"
 #include "base/utility.hpp"
 
+#include <limits>
+#include <memory>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace lk
 {
 
+struct TransactionLocation
+{
+    base::Sha256 block_hash;
+    std::size_t index_in_block;
+
+    void serialize(base::SerializationOArchive& oa) const;
+    static TransactionLocation deserialize(base::SerializationIArchive& ia);
+};
+
+
+/*
+ * Serialized state of accounts after applying the block with the given depth and hash.
+ */
+struct StateSnapshot
+{
+    BlockDepth depth;
+    base::Sha256 block_hash;
+    base::Bytes state;
+
+    void serialize(base::SerializationOArchive& oa) const;
+    static StateSnapshot deserialize(base::SerializationIArchive& ia);
+};
+
+
+/*
+ * Entry of an account history: the transaction sent from the address with the given sequence number.
+ */
+struct AccountTransaction
+{
+    lk::Address address;
+    std::uint64_t sequence_number;
+    base::Sha256 tx_hash;
+};
+
+
+/*
+ * Outputs of transactions of a block, stored together with the block.
+ */
+struct BlockOutputs
+{
+    std::vector<std::pair<base::Sha256, TransactionStatus>> statuses;
+    std::vector<AccountTransaction> accounts_transactions;
+    std::vector<std::pair<base::Sha256, ContractCode>> contracts_code; // deployed by the block
+};
+
 
 class IBlockchain
 {
@@ -38,6 +87,7 @@ class IBlockchain
     virtual AdditionResult tryAddBlock(const ImmutableBlock& block) = 0;
     //===================
     virtual std::optional<ImmutableBlock> findBlock(const base::Sha256& block_hash) const = 0;
+    virtual std::optional<BlockHeader> findBlockHeader(const base::Sha256& block_hash) const = 0;
     virtual std::optional<base::Sha256> findBlockHashByDepth(BlockDepth depth) const = 0;
     //===================
     virtual ImmutableBlock getGenesisBlock() const = 0;
@@ -54,7 +104,10 @@ class Blockchain : public IBlockchain
 {
   public:
     //===================
-    Blockchain(ImmutableBlock genesis_block);
+    using BlocksCacheStats = base::LruCache<base::Sha256, std::shared_ptr<const ImmutableBlock>>::Stats;
+    //===================
+    Blockchain(ImmutableBlock genesis_block,
+               std::size_t blocks_cache_bytes = std::numeric_limits<std::size_t>::max());
     Blockchain(const Blockchain&) = delete;
     Blockchain(Blockchain&&) = delete;
     ~Blockchain() override = default;
@@ -63,6 +116,7 @@ class Blockchain : public IBlockchain
     //===================
     std::optional<base::Sha256> findBlockHashByDepth(BlockDepth depth) const override;
     std::optional<ImmutableBlock> findBlock(const base::Sha256& block_hash) const override;
+    std::optional<BlockHeader> findBlockHeader(const base::Sha256& block_hash) const override;
     std::optional<Transaction> findTransaction(const base::Sha256& tx_hash) const override;
     //===================
     ImmutableBlock getGenesisBlock() const override;
@@ -70,10 +124,30 @@ class Blockchain : public IBlockchain
     ImmutableBlock getTopBlock() const override;
     base::Sha256 getTopBlockHash() const override;
     //===================
+    BlocksCacheStats getBlocksCacheStats() const;
+    //===================
+  protected:
+    //===================
+    /*
+     * Called when a block of this chain is not in the blocks cache. Blockchain itself never evicts
+     * blocks, so here it is nothing to look for; chains with a backing storage override it.
+     */
+    virtual std::optional<ImmutableBlock> findEvictedBlock(const base::Sha256& block_hash) const;
+    virtual std::optional<BlockHeader> findEvictedBlockHeader(const base::Sha256& block_hash) const;
+
+    /*
+     * Fast path for blocks that were already validated, e.g. loaded from own storage: only the block
+     * linkage with the top block is checked. Transactions hashes must be in the same order as in block.
+     */
+    AdditionResult addTrustedBlock(ImmutableBlock block, const std::vector<base::Sha256>& transactions_hashes);
+    //===================
   private:
     //===================
-    std::unordered_map<base::Sha256, const ImmutableBlock> _blocks;
+    mutable base::LruCache<base::Sha256, std::shared_ptr<const ImmutableBlock>> _blocks_cache;
     std::map<lk::BlockDepth, base::Sha256> _blocks_by_depth;
+    std::unordered_map<base::Sha256, TransactionLocation> _transactions_index;
+    std::shared_ptr<const ImmutableBlock> _genesis_block;
+    std::shared_ptr<const ImmutableBlock> _top_block;
     base::Sha256 _genesis_block_hash;
     base::Sha256 _top_level_block_hash;
     mutable std::shared_mutex _blocks_mutex;
@@ -85,6 +159,28 @@ class Blockchain : public IBlockchain
      * but it is an unsafe version. Used in getTopBlock(), only with lock.
      */
     const ImmutableBlock& _getTopBlock() const;
+
+    /*
+     * Thread-unsafe: looks for a block of this chain in the cache and then in the storage. Used only with lock.
+     */
+    std::shared_ptr<const ImmutableBlock> _findBlock(const base::Sha256& block_hash) const;
+    std::optional<BlockHeader> _findBlockHeader(const base::Sha256& block_hash) const;
+
+    /*
+     * Thread-unsafe: checks that the block with given depth and hash is a part of this chain. Used only with lock.
+     */
+    bool _isInChain(BlockDepth depth, const base::Sha256& block_hash) const;
+
+    /*
+     * Thread-unsafe: makes the block new top of the chain. Used only with lock.
+     */
+    void _appendBlock(std::shared_ptr<const ImmutableBlock> block);
+
+    /*
+     * Thread-unsafe: adds all transactions of the block to the index. Used only with lock.
+     */
+    void _indexBlockTransactions(const ImmutableBlock& block);
+    void _indexBlockTransactions(const ImmutableBlock& block, const std::vector<base::Sha256>& transactions_hashes);
     //===================
     Consensus _consensus;
     bool checkConsensus(const ImmutableBlock& block) const;
@@ -94,27 +190,67 @@ class Blockchain : public IBlockchain
 };
 
 
-class PersistentBlockchain : public Blockchain
+class PersistentBlockchain : public Blockchain, public ICodeStorage
 {
   public:
+    //===================
+    struct LoadingStats
+    {
+        std::size_t blocks_count;
+        unsigned long long elapsed_millis;
+    };
     //===================
     PersistentBlockchain(ImmutableBlock genesis_block, base::json::Value config);
     PersistentBlockchain(const Blockchain&) = delete;
     PersistentBlockchain(Blockchain&&) = delete;
     ~PersistentBlockchain() override = default;
     //===================
-    void load();
+    /*
+     * Loads blocks that were committed to own storage. Blocks are read by a prefetching thread,
+     * deserialized and hashed by a thread pool and then applied in order without full validation.
+     */
+    LoadingStats load();
     //===================
-    AdditionResult tryAddBlock(const ImmutableBlock& block) override;
+    /*
+     * tryAddBlock adds a block to memory only. When its transactions are applied, the block is stored together
+     * with their outputs in one atomic write, so a crash never leaves a stored block without its outputs.
+     */
+    void pushForwardToPersistentStorage(const ImmutableBlock& block, const BlockOutputs& outputs);
+    //===================
+    std::optional<Transaction> findTransaction(const base::Sha256& tx_hash) const override;
+    //===================
+    std::optional<TransactionStatus> findTransactionStatus(const base::Sha256& tx_hash) const;
+    //===================
+    /*
+     * Returns up to count hashes of transactions sent from the address, starting from the given sequence number.
+     */
+    std::vector<base::Sha256> findAccountTransactions(const lk::Address& address,
+                                                      std::uint64_t first_sequence_number,
+                                                      std::size_t count) const;
+    //===================
+    void saveStateSnapshot(const StateSnapshot& snapshot);
+
+    /*
+     * Returns the latest saved snapshot if it belongs to the loaded chain.
+     */
+    std::optional<StateSnapshot> loadStateSnapshot() const;
+    //===================
+    std::optional<base::Bytes> findContractCode(const base::Sha256& code_hash) const override;
+    //===================
+  protected:
+    std::optional<ImmutableBlock> findEvictedBlock(const base::Sha256& block_hash) const override;
+    std::optional<BlockHeader> findEvictedBlockHeader(const base::Sha256& block_hash) const override;
     //===================
   private:
     base::Database _database;
     mutable std::shared_mutex _database_rw_mutex;
     //===================
-    void pushForwardToPersistentStorage(const ImmutableBlock& block);
     std::optional<base::Sha256> getLastBlockHashAtPersistentStorage() const;
+    std::optional<base::Sha256> findBlockHashByDepthAtPersistentStorage(BlockDepth depth) const;
+    std::optional<BlockHeader> findBlockHeaderAtPersistentStorage(const base::Sha256& block_hash) const;
+    std::optional<TransactionsSet> findBlockBodyAtPersistentStorage(const base::Sha256& block_hash) const;
     std::optional<ImmutableBlock> findBlockAtPersistentStorage(const base::Sha256& block_hash) const;
-    std::vector<base::Sha256> createAllBlockHashesListAtPersistentStorage() const;
+    std::optional<TransactionLocation> findTransactionLocationAtPersistentStorage(const base::Sha256& tx_hash) const;
     //===================
 };
 
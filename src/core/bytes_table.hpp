@@ -0,0 +1,85 @@
+#pragma once
+
+#include "base/bytes.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace lk
+{
+
+/*
+ * Bytes of a key, by which its slot in a table is found. Keys are fixed-size byte strings or wrap one,
+ * in which case an overload is declared next to the key type.
+ */
+template<std::size_t S>
+const base::FixedBytes<S>& getKeyBytes(const base::FixedBytes<S>& key) noexcept
+{
+    return key;
+}
+
+
+/*
+ * Hash table from a fixed-size key to a value with open addressing: entries lie in one array and a lookup probes
+ * neighbouring slots instead of following pointers. Keys are mostly digests, so the slot is found from a few
+ * of their bytes. Pointers to values are invalidated by any insertion, as the array can grow.
+ */
+template<typename K, typename T>
+class BytesTable
+{
+  public:
+    //=================
+    BytesTable() = default;
+    BytesTable(const BytesTable&) = default;
+    BytesTable(BytesTable&& other) noexcept;
+    BytesTable& operator=(const BytesTable&) = default;
+    BytesTable& operator=(BytesTable&& other) noexcept;
+    ~BytesTable() = default;
+    //=================
+    T* find(const K& key);
+    const T* find(const K& key) const;
+    bool contains(const K& key) const;
+    //=================
+    std::pair<T*, bool> insert(const K& key, T value); // doesn't replace an existing value
+    T& insertOrAssign(const K& key, T value);
+    bool erase(const K& key);
+    void clear();
+    //=================
+    std::size_t size() const noexcept;
+    bool isEmpty() const noexcept;
+    //=================
+    template<typename F>
+    void forEach(F&& f) const; // f(const K&, const T&)
+
+    template<typename F>
+    void forEach(F&& f); // f(const K&, T&)
+    //=================
+  private:
+    //=================
+    static constexpr std::size_t MIN_CAPACITY = 16;
+    // linear probing gets long chains when the table is full, so it grows at 3/4 of capacity
+    static constexpr std::size_t MAX_LOAD_NUMERATOR = 3;
+    static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+    //=================
+    struct Entry
+    {
+        K key;
+        T value;
+    };
+    //=================
+    std::vector<std::optional<Entry>> _slots; // capacity is always a power of 2
+    std::size_t _size{ 0 };
+    unsigned _shift{ 64 };
+    //=================
+    std::size_t getHomeSlot(const K& key) const noexcept;
+    std::size_t findSlot(const K& key) const noexcept; // the slot of the key or an empty one
+    void reserveForOneMore();
+    void rehash(std::size_t new_capacity);
+    //=================
+};
+
+} // namespace lk
+
+#include "bytes_table.tpp"
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+
+namespace lk
+{
+
+template<typename K, typename T>
+BytesTable<K, T>::BytesTable(BytesTable&& other) noexcept
+  : _slots{ std::move(other._slots) }
+  , _size{ std::exchange(other._size, 0) }
+  , _shift{ std::exchange(other._shift, 64) }
+{
+    other._slots.clear();
+}
+
+
+template<typename K, typename T>
+BytesTable<K, T>& BytesTable<K, T>::operator=(BytesTable&& other) noexcept
+{
+    if (this != &other) {
+        _slots = std::move(other._slots);
+        _size = std::exchange(other._size, 0);
+        _shift = std::exchange(other._shift, 64);
+        other._slots.clear();
+    }
+    return *this;
+}
+
+
+template<typename K, typename T>
+T* BytesTable<K, T>::find(const K& key)
+{
+    if (_slots.empty()) {
+        return nullptr;
+    }
+    auto& slot = _slots[findSlot(key)];
+    return slot ? &slot->value : nullptr;
+}
+
+
+template<typename K, typename T>
+const T* BytesTable<K, T>::find(const K& key) const
+{
+    if (_slots.empty()) {
+        return nullptr;
+    }
+    const auto& slot = _slots[findSlot(key)];
+    return slot ? &slot->value : nullptr;
+}
+
+
+template<typename K, typename T>
+bool BytesTable<K, T>::contains(const K& key) const
+{
+    return find(key) != nullptr;
+}
+
+
+template<typename K, typename T>
+std::pair<T*, bool> BytesTable<K, T>::insert(const K& key, T value)
+{
+    if (auto found = find(key)) {
+        return { found, false };
+    }
+    reserveForOneMore();
+    auto& slot = _slots[findSlot(key)];
+    slot.emplace(Entry{ key, std::move(value) });
+    ++_size;
+    return { &slot->value, true };
+}
+
+
+template<typename K, typename T>
+T& BytesTable<K, T>::insertOrAssign(const K& key, T value)
+{
+    if (auto found = find(key)) {
+        *found = std::move(value);
+        return *found;
+    }
+    return *insert(key, std::move(value)).first;
+}
+
+
+template<typename K, typename T>
+bool BytesTable<K, T>::erase(const K& key)
+{
+    if (_slots.empty()) {
+        return false;
+    }
+    auto hole = findSlot(key);
+    if (!_slots[hole]) {
+        return false;
+    }
+    _slots[hole].reset();
+    --_size;
+
+    // entries after the hole are shifted back, so that no probe sequence is broken and no tombstones are needed
+    const auto mask = _slots.size() - 1;
+    for (auto i = (hole + 1) & mask; _slots[i]; i = (i + 1) & mask) {
+        const auto home = getHomeSlot(_slots[i]->key);
+        // the entry can't move if its home slot is cyclically in (hole, i]
+        const bool stays = hole < i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            _slots[hole] = std::move(_slots[i]);
+            _slots[i].reset();
+            hole = i;
+        }
+    }
+    return true;
+}
+
+
+template<typename K, typename T>
+void BytesTable<K, T>::clear()
+{
+    _slots.clear();
+    _size = 0;
+    _shift = 64;
+}
+
+
+template<typename K, typename T>
+std::size_t BytesTable<K, T>::size() const noexcept
+{
+    return _size;
+}
+
+
+template<typename K, typename T>
+bool BytesTable<K, T>::isEmpty() const noexcept
+{
+    return _size == 0;
+}
+
+
+template<typename K, typename T>
+template<typename F>
+void BytesTable<K, T>::forEach(F&& f) const
+{
+    for (const auto& slot : _slots) {
+        if (slot) {
+            f(slot->key, static_cast<const T&>(slot->value));
+        }
+    }
+}
+
+
+template<typename K, typename T>
+template<typename F>
+void BytesTable<K, T>::forEach(F&& f)
+{
+    for (auto& slot : _slots) {
+        if (slot) {
+            f(static_cast<const K&>(slot->key), slot->value);
+        }
+    }
+}
+
+
+template<typename K, typename T>
+std::size_t BytesTable<K, T>::getHomeSlot(const K& key) const noexcept
+{
+    // the first and the last 8 bytes are taken, so keys with a common prefix, like small integers, are still spread,
+    // and the product with the golden ratio mixes them into the high bits used as the slot index
+    const auto& bytes = getKeyBytes(key);
+    static_assert(sizeof(bytes) >= sizeof(std::uint64_t), "keys must be at least 8 bytes long");
+    std::uint64_t head;
+    std::uint64_t tail;
+    std::memcpy(&head, bytes.getData(), sizeof(head));
+    std::memcpy(&tail, bytes.getData() + bytes.size() - sizeof(tail), sizeof(tail));
+    const auto mixed = (head ^ std::rotl(tail, 32)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(mixed >> _shift);
+}
+
+
+template<typename K, typename T>
+std::size_t BytesTable<K, T>::findSlot(const K& key) const noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto i = getHomeSlot(key);
+    while (_slots[i] && _slots[i]->key != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+
+template<typename K, typename T>
+void BytesTable<K, T>::reserveForOneMore()
+{
+    if (_slots.empty()) {
+        rehash(MIN_CAPACITY);
+    }
+    else if ((_size + 1) * MAX_LOAD_DENOMINATOR > _slots.size() * MAX_LOAD_NUMERATOR) {
+        rehash(_slots.size() * 2);
+    }
+}
+
+
+template<typename K, typename T>
+void BytesTable<K, T>::rehash(std::size_t new_capacity)
+{
+    auto old_slots = std::move(_slots);
+    _slots = std::vector<std::optional<Entry>>(new_capacity);
+    _shift = 64 - static_cast<unsigned>(std::countr_zero(new_capacity));
+    for (auto& slot : old_slots) {
+        if (slot) {
+            _slots[findSlot(slot->key)] = std::move(slot);
+        }
+    }
+}
+
+} // namespace lk
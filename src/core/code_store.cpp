@@ -0,0 +1,94 @@
+#include "code_store.hpp"
+
+#include "base/error.hpp"
+
+namespace lk
+{
+
+void CodeStore::setStorage(ICodeStorage& storage)
+{
+    std::lock_guard lk(_mutex);
+    _storage = &storage;
+}
+
+
+ContractCode CodeStore::find(const base::Sha256& code_hash) const
+{
+    static const ContractCode empty_code = std::make_shared<const base::Bytes>();
+    if (code_hash == base::Sha256::null()) {
+        return empty_code;
+    }
+
+    std::lock_guard lk(_mutex);
+    auto it = _entries.find(code_hash);
+    if (it != _entries.end() && it->second.code) {
+        return it->second.code;
+    }
+
+    std::optional<base::Bytes> stored_code;
+    if (_storage) {
+        stored_code = _storage->findContractCode(code_hash);
+    }
+    if (!stored_code) {
+        RAISE_ERROR(base::DatabaseError, "contract code is not found");
+    }
+
+    auto code = std::make_shared<const base::Bytes>(std::move(*stored_code));
+    if (it != _entries.end()) {
+        // only code of existing accounts is kept, the rest is read again if needed
+        it->second.code = code;
+    }
+    return code;
+}
+
+
+void CodeStore::addReference(const base::Sha256& code_hash, ContractCode code)
+{
+    if (code_hash == base::Sha256::null()) {
+        return;
+    }
+
+    std::lock_guard lk(_mutex);
+    auto& entry = _entries[code_hash];
+    if (code && !entry.code) {
+        // an entry with references but without code was restored, so its code is already stored
+        if (entry.references == 0) {
+            _new_code.emplace_back(code_hash, code);
+        }
+        entry.code = std::move(code);
+    }
+    ++entry.references;
+}
+
+
+void CodeStore::removeReference(const base::Sha256& code_hash)
+{
+    std::lock_guard lk(_mutex);
+    auto it = _entries.find(code_hash);
+    if (it != _entries.end() && --it->second.references == 0) {
+        _entries.erase(it);
+    }
+}
+
+
+void CodeStore::clear()
+{
+    std::lock_guard lk(_mutex);
+    _entries.clear();
+}
+
+
+std::vector<std::pair<base::Sha256, ContractCode>> CodeStore::takeNewCode()
+{
+    std::lock_guard lk(_mutex);
+    return std::exchange(_new_code, {});
+}
+
+
+std::size_t CodeStore::size() const
+{
+    std::lock_guard lk(_mutex);
+    return _entries.size();
+}
+
+} // namespace lk
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "base/bytes.hpp"
+#include "base/hash.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lk
+{
+
+/*
+ * Runtime code of a contract. It never changes after deployment, so one copy is shared by all accounts
+ * with the same code and by every call frame running it.
+ */
+using ContractCode = std::shared_ptr<const base::Bytes>;
+
+
+/*
+ * Persistent storage of contracts code, which is read by the code hash.
+ */
+class ICodeStorage
+{
+  public:
+    virtual ~ICodeStorage() = default;
+
+    virtual std::optional<base::Bytes> findContractCode(const base::Sha256& code_hash) const = 0;
+};
+
+
+/*
+ * Contracts code addressed by its hash and counted by accounts referring to it. The store never writes to the
+ * storage: new code is kept in memory and handed out by takeNewCode, so that it's stored together with the block
+ * deploying it. Code of a restored state is read from the storage on its first use. Code that no account refers to
+ * is dropped from memory, but stays in the storage.
+ */
+class CodeStore
+{
+  public:
+    //================
+    CodeStore() = default;
+    CodeStore(const CodeStore&) = delete;
+    CodeStore(CodeStore&&) = delete;
+    CodeStore& operator=(const CodeStore&) = delete;
+    CodeStore& operator=(CodeStore&&) = delete;
+    ~CodeStore() = default;
+    //================
+    void setStorage(ICodeStorage& storage);
+    //================
+    /*
+     * Returns the empty code for the null hash. Raises an error if the code is neither in memory nor in the storage.
+     */
+    ContractCode find(const base::Sha256& code_hash) const;
+    //================
+    void addReference(const base::Sha256& code_hash, ContractCode code = nullptr); // no code to load it later
+    void removeReference(const base::Sha256& code_hash);
+    void clear();
+    //================
+    /*
+     * Returns code that was added since the previous call and isn't known to be in the storage yet.
+     */
+    std::vector<std::pair<base::Sha256, ContractCode>> takeNewCode();
+    //================
+    std::size_t size() const; // number of distinct codes
+    //================
+  private:
+    //================
+    struct Entry
+    {
+        mutable ContractCode code; // not loaded yet if null
+        std::size_t references{ 0 };
+    };
+    //================
+    std::unordered_map<base::Sha256, Entry> _entries;
+    std::vector<std::pair<base::Sha256, ContractCode>> _new_code;
+    ICodeStorage* _storage{ nullptr };
+    mutable std::mutex _mutex;
+    //================
+};
+
+} // namespace lk
@@ -61,9 +61,9 @@ bool Consensus::checkBlock(const ImmutableBlock& block) const
 }
 
 
-void Consensus::applyBlock(ImmutableBlock block)
+void Consensus::applyBlock(const BlockHeader& block)
 {
-    _last_blocks.push(std::move(block)); // TODO: change it, of course
+    _last_blocks.push(block);
     if (_last_blocks.size() < base::config::BC_DIFFICULTY_RECALCULATION_RATE) {
         // means we do not have enough block to recalculate anything
         return;
@@ -77,7 +77,7 @@ void Consensus::applyBlock(ImmutableBlock block)
         return;
     }
 
-    const ImmutableBlock& p = _last_blocks.front();
+    const BlockHeader& p = _last_blocks.front();
 
     auto elapsed = (block.getTimestamp() - p.getTimestamp()).getSeconds();
     ASSERT(elapsed);
@@ -37,12 +37,13 @@ class Consensus
 
     bool checkBlock(const ImmutableBlock& block) const;
 
-    void applyBlock(ImmutableBlock block);
+    // retargeting uses only block timestamps, so headers are enough
+    void applyBlock(const BlockHeader& block);
 
     const Complexity& getComplexity() const;
 
   private:
-    std::queue<ImmutableBlock> _last_blocks;
+    std::queue<BlockHeader> _last_blocks;
     Complexity _complexity;
 };
 
@@ -4,8 +4,93 @@
 #include "vm/tools.hpp"
 
 #include "base/log.hpp"
+#include "base/time.hpp"
 
 #include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+
+lk::BlockDepth getStateSnapshotInterval(base::json::Value& database_config)
+{
+    if (database_config.has_number_field("state_snapshot_interval")) {
+        auto interval_value = database_config["state_snapshot_interval"].as_number();
+        if (interval_value.is_uint64() && interval_value.to_uint64() > 0) {
+            return interval_value.to_uint64();
+        }
+        RAISE_ERROR(base::InvalidArgument, "database \"state_snapshot_interval\" must be a positive integer");
+    }
+    return base::config::DATABASE_STATE_SNAPSHOT_INTERVAL;
+}
+
+
+std::size_t getSignatureVerificationThreads(const base::json::Value& config)
+{
+    if (config.has_number_field("signature_verification_threads")) {
+        auto threads_value = config.at("signature_verification_threads").as_number();
+        if (threads_value.is_uint64() && threads_value.to_uint64() > 0) {
+            return threads_value.to_uint64();
+        }
+        RAISE_ERROR(base::InvalidArgument, "\"signature_verification_threads\" must be a positive integer");
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+std::size_t getMempoolLimit(const base::json::Value& config, const std::string& name, std::size_t default_value)
+{
+    if (config.has_number_field(name)) {
+        auto value = config.at(name).as_number();
+        if (value.is_uint64() && value.to_uint64() > 0) {
+            return value.to_uint64();
+        }
+        RAISE_ERROR(base::InvalidArgument, "mempool \"" + name + "\" must be a positive integer");
+    }
+    return default_value;
+}
+
+
+lk::Mempool::Limits getMempoolLimits(const base::json::Value& config)
+{
+    static const auto empty_config = base::json::Value::object();
+    const auto& mempool_config = config.has_object_field("mempool") ? config.at("mempool") : empty_config;
+    return { getMempoolLimit(mempool_config, "max_transactions", base::config::MEMPOOL_MAX_TRANSACTIONS),
+             getMempoolLimit(mempool_config, "max_bytes", base::config::MEMPOOL_MAX_BYTES),
+             std::chrono::seconds{ getMempoolLimit(
+               mempool_config, "transaction_lifetime", base::config::MEMPOOL_TRANSACTION_LIFETIME) } };
+}
+
+constexpr const char* MEMPOOL_EXPIRED_MESSAGE = "dropped from pending: the transaction timestamp is too old";
+constexpr const char* MEMPOOL_EVICTED_MESSAGE = "evicted from pending: the mempool is full of higher fee per byte";
+constexpr const char* MEMPOOL_FULL_MESSAGE = "not added to pending: the mempool is full of higher fee per byte";
+
+
+lk::TransactionStatus makeAdditionStatus(lk::Mempool::AdditionResult addition_result, lk::Fee fee)
+{
+    switch (addition_result) {
+        case lk::Mempool::AdditionResult::ADDED:
+        case lk::Mempool::AdditionResult::ALREADY_PENDING:
+            return lk::TransactionStatus{
+                lk::TransactionStatus::StatusCode::Pending, lk::TransactionStatus::ActionType::None, fee, ""
+            };
+        case lk::Mempool::AdditionResult::MEMPOOL_FULL:
+            return lk::TransactionStatus{ lk::TransactionStatus::StatusCode::Failed,
+                                          lk::TransactionStatus::ActionType::None,
+                                          fee,
+                                          MEMPOOL_FULL_MESSAGE };
+        case lk::Mempool::AdditionResult::EXPIRED:
+        default:
+            return lk::TransactionStatus{ lk::TransactionStatus::StatusCode::Failed,
+                                          lk::TransactionStatus::ActionType::None,
+                                          fee,
+                                          MEMPOOL_EXPIRED_MESSAGE };
+    }
+}
+
+} // namespace
+
 
 namespace lk
 {
@@ -14,21 +99,24 @@ Core::Core(base::json::Value config)
   : _config{ std::move(config) }
   , _vault{ _config["keys_dir"].as_string() }
   , _this_node_address{ _vault.getKey().toPublicKey() }
+  , _state_snapshot_interval{ getStateSnapshotInterval(_config["database"]) }
+  , _signature_verifier{ getSignatureVerificationThreads(_config), base::config::BC_VERIFIED_SIGNATURES_CACHE_SIZE }
   , _blockchain{ getGenesisBlock(), std::move(_config["database"]) }
   , _host{ std::move(_config["net"]), 0xFFFF, *this }
   , _vm{ vm::load() }
+  , _mempool{ base::config::BC_MAX_TRANSACTIONS_IN_BLOCK, getMempoolLimits(_config) }
+  , _tx_outputs_cache{ base::config::DATABASE_TRANSACTIONS_STATUSES_CACHE_SIZE }
 {
-    _state_manager.updateFromGenesis(getGenesisBlock());
+    base::Timer startup_timer;
+    startup_timer.start();
 
     _blockchain.load();
-    for (lk::BlockDepth d = 1; d <= _blockchain.getTopBlock().getDepth(); ++d) {
-        auto block = *_blockchain.findBlock(*_blockchain.findBlockHashByDepth(d));
-        for (const auto& tx : block.getTransactions()) {
-            tryPerformTransaction(tx, block);
-        }
-    }
+    _state_manager.setCodeStorage(_blockchain);
+    restoreState();
+    LOG_INFO << "Core startup took " << startup_timer.elapsedMillis() << " ms";
 
     subscribeToNewPendingTransaction([this](const lk::Transaction& tx) { _host.broadcast(tx); });
+    subscribeToNewPendingTransactions([this](const lk::TransactionsSet& txs) { _host.broadcast(txs); });
 
     subscribeToBlockMining([this](const ImmutableBlock& block) { _host.broadcastNewBlock(block); });
     _state_manager.subscribeToAnyAccountUpdate(std::bind(&Core::on_account_updated, this, std::placeholders::_1));
@@ -63,6 +151,40 @@ const ImmutableBlock& Core::getGenesisBlock()
 }
 
 
+void Core::restoreState()
+{
+    lk::BlockDepth replay_from_depth = 1;
+    if (auto snapshot = _blockchain.loadStateSnapshot()) {
+        _state_manager.restoreSnapshot(snapshot->state);
+        replay_from_depth = snapshot->depth + 1;
+        LOG_INFO << "Restored state snapshot at block #" << snapshot->depth;
+    }
+    else {
+        _state_manager.updateFromGenesis(getGenesisBlock());
+    }
+
+    const auto top_block_depth = _blockchain.getTopBlock().getDepth();
+    for (lk::BlockDepth d = replay_from_depth; d <= top_block_depth; ++d) {
+        auto block = *_blockchain.findBlock(*_blockchain.findBlockHashByDepth(d));
+        // outputs were stored together with the block, so the replay only restores the state
+        applyBlockTransactions(block);
+    }
+
+    if (top_block_depth >= replay_from_depth) {
+        LOG_INFO << "Replayed blocks from #" << replay_from_depth << " to #" << top_block_depth;
+        if (top_block_depth - replay_from_depth + 1 >= _state_snapshot_interval) {
+            saveStateSnapshot(_blockchain.getTopBlock());
+        }
+    }
+}
+
+
+void Core::saveStateSnapshot(const ImmutableBlock& block)
+{
+    _blockchain.saveStateSnapshot(StateSnapshot{ block.getDepth(), block.getHash(), _state_manager.takeSnapshot() });
+}
+
+
 void Core::run()
 {
     _host.run();
@@ -74,7 +196,7 @@ void Core::addPendingTransaction(const lk::Transaction& tx)
     auto transaction_hash = tx.hashOfTransaction();
     auto transaction_cost = tx.getAmount() + tx.getFee();
 
-    if (!tx.checkSign()) {
+    if (!_signature_verifier.verify(tx)) {
         LOG_DEBUG << "Failed signature verification";
         TransactionStatus status{
             TransactionStatus::StatusCode::BadSign, TransactionStatus::ActionType::None, tx.getFee(), ""
@@ -92,23 +214,22 @@ void Core::addPendingTransaction(const lk::Transaction& tx)
         }
     }
 
-    std::map<lk::Address, lk::Balance> current_pending_balance;
+    lk::Balance pending_from_account_spend;
     {
         std::shared_lock lk(_pending_transactions_mutex);
-        if (_pending_transactions.find(tx)) {
+        if (_mempool.contains(transaction_hash)) {
             TransactionStatus status{
                 TransactionStatus::StatusCode::Pending, TransactionStatus::ActionType::None, tx.getFee(), ""
             };
             return addTransactionOutput(transaction_hash, status);
         }
 
-        current_pending_balance = lk::calcCost(_pending_transactions);
+        pending_from_account_spend = _mempool.getPendingSpend(tx.getFrom());
     }
 
-    const auto& pending_from_account_balance = current_pending_balance.find(tx.getFrom());
-    if ((pending_from_account_balance != current_pending_balance.end()) && (_state_manager.hasAccount(tx.getFrom()))) {
+    if (pending_from_account_spend > 0 && _state_manager.hasAccount(tx.getFrom())) {
         auto current_account_balance = _state_manager.getAccountInfo(tx.getFrom()).balance;
-        if (pending_from_account_balance->second + transaction_cost > current_account_balance) {
+        if (pending_from_account_spend + transaction_cost > current_account_balance) {
             TransactionStatus status{
                 TransactionStatus::StatusCode::NotEnoughBalance, TransactionStatus::ActionType::None, 0, ""
             };
@@ -124,48 +245,172 @@ void Core::addPendingTransaction(const lk::Transaction& tx)
     }
 
     LOG_DEBUG << "Adding tx to pending:" << transaction_hash;
+    Mempool::AdditionResult addition_result;
+    std::vector<lk::Transaction> expired;
+    std::vector<lk::Transaction> evicted;
     {
         std::unique_lock lk(_pending_transactions_mutex);
-        _pending_transactions.add(tx);
+        const auto now = base::Time::now();
+        expired = _mempool.removeExpired(now);
+        addition_result = _mempool.add(tx, now, evicted);
     }
+    notifyDroppedTransactions(expired, MEMPOOL_EXPIRED_MESSAGE);
+    notifyDroppedTransactions(evicted, MEMPOOL_EVICTED_MESSAGE);
 
-    _event_new_pending_transaction.notify(tx);
-    TransactionStatus status{
-        TransactionStatus::StatusCode::Pending, TransactionStatus::ActionType::None, tx.getFee(), ""
-    };
-    return addTransactionOutput(transaction_hash, status);
+    if (addition_result == Mempool::AdditionResult::ADDED) {
+        _event_new_pending_transaction.notify(tx);
+    }
+    addTransactionOutput(transaction_hash, makeAdditionStatus(addition_result, tx.getFee()));
+}
+
+
+std::vector<TransactionStatus> Core::addPendingTransactions(const std::vector<lk::Transaction>& txs)
+{
+    std::vector<std::optional<TransactionStatus>> statuses(txs.size());
+    const auto is_sign_valid = _signature_verifier.verifyEach(txs);
+
+    // balances are read once per sender, before the pending set is locked
+    std::unordered_map<lk::Address, std::optional<lk::Balance>> balances;
+    for (std::size_t i = 0; i < txs.size(); ++i) {
+        const auto& tx = txs[i];
+        if (!is_sign_valid[i]) {
+            statuses[i] = TransactionStatus{
+                TransactionStatus::StatusCode::BadSign, TransactionStatus::ActionType::None, tx.getFee(), ""
+            };
+        }
+        else if (_blockchain.findTransaction(tx.hashOfTransaction())) {
+            statuses[i] = getTransactionOutput(tx.hashOfTransaction());
+        }
+        else if (!balances.contains(tx.getFrom())) {
+            std::optional<lk::Balance> balance;
+            if (_state_manager.hasAccount(tx.getFrom())) {
+                balance = _state_manager.getAccountInfo(tx.getFrom()).balance;
+            }
+            balances.emplace(tx.getFrom(), std::move(balance));
+        }
+    }
+
+    std::vector<bool> is_added(txs.size(), false);
+    std::vector<lk::Transaction> expired;
+    std::vector<lk::Transaction> evicted;
+    {
+        std::unique_lock lk(_pending_transactions_mutex);
+        const auto now = base::Time::now();
+        expired = _mempool.removeExpired(now);
+        for (std::size_t i = 0; i < txs.size(); ++i) {
+            const auto& tx = txs[i];
+            if (statuses[i]) {
+                continue;
+            }
+            if (_mempool.contains(tx.hashOfTransaction())) {
+                statuses[i] = makeAdditionStatus(Mempool::AdditionResult::ALREADY_PENDING, tx.getFee());
+                continue;
+            }
+
+            // the pending spend already includes transactions of the batch added before this one
+            const auto& balance = balances.find(tx.getFrom())->second;
+            if (!balance || _mempool.getPendingSpend(tx.getFrom()) + tx.getAmount() + tx.getFee() > *balance) {
+                statuses[i] = TransactionStatus{
+                    TransactionStatus::StatusCode::NotEnoughBalance, TransactionStatus::ActionType::None, 0, ""
+                };
+                continue;
+            }
+
+            const auto addition_result = _mempool.add(tx, now, evicted);
+            is_added[i] = addition_result == Mempool::AdditionResult::ADDED;
+            statuses[i] = makeAdditionStatus(addition_result, tx.getFee());
+        }
+    }
+    notifyDroppedTransactions(expired, MEMPOOL_EXPIRED_MESSAGE);
+    notifyDroppedTransactions(evicted, MEMPOOL_EVICTED_MESSAGE);
+
+    // a transaction of the batch can be evicted by a later one with a higher fee per byte
+    std::unordered_set<base::Sha256> evicted_hashes;
+    for (const auto& tx : evicted) {
+        evicted_hashes.insert(tx.hashOfTransaction());
+    }
+
+    std::vector<TransactionStatus> ret;
+    ret.reserve(txs.size());
+    TransactionsSet added;
+    for (std::size_t i = 0; i < txs.size(); ++i) {
+        const auto& tx_hash = txs[i].hashOfTransaction();
+        if (evicted_hashes.contains(tx_hash)) {
+            // already reported as dropped
+            ret.emplace_back(TransactionStatus::StatusCode::Failed,
+                             TransactionStatus::ActionType::None,
+                             txs[i].getFee(),
+                             MEMPOOL_EVICTED_MESSAGE);
+            continue;
+        }
+        if (is_added[i]) {
+            added.add(txs[i]);
+        }
+        addTransactionOutput(tx_hash, *statuses[i]);
+        ret.push_back(std::move(*statuses[i]));
+    }
+
+    if (!added.isEmpty()) {
+        _event_new_pending_transactions.notify(added);
+    }
+    return ret;
+}
+
+
+void Core::notifyDroppedTransactions(const std::vector<lk::Transaction>& txs, const std::string& reason)
+{
+    for (const auto& tx : txs) {
+        LOG_DEBUG << "Dropped pending tx " << tx.hashOfTransaction() << ": " << reason;
+        TransactionStatus status{
+            TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::None, tx.getFee(), reason
+        };
+        addTransactionOutput(tx.hashOfTransaction(), status);
+    }
 }
 
 
 std::optional<TransactionStatus> Core::getTransactionOutput(const base::Sha256& tx)
 {
-    std::shared_lock lk(_tx_outputs_mutex);
-    if (auto it = _tx_outputs.find(tx); it != _tx_outputs.end()) {
-        return it->second;
+    if (auto status = _tx_outputs_cache.find(tx)) {
+        return status;
+    }
+    else if (auto stored_status = _blockchain.findTransactionStatus(tx)) {
+        _tx_outputs_cache.put(tx, *stored_status);
+        return stored_status;
     }
     else {
-        return TransactionStatus{ TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::None, 0, "" };
+        // statuses of pending transactions are kept only in the cache, so they may be evicted from it
+        std::shared_lock lk(_pending_transactions_mutex);
+        const auto status_code =
+          _mempool.contains(tx) ? TransactionStatus::StatusCode::Pending : TransactionStatus::StatusCode::Failed;
+        return TransactionStatus{ status_code, TransactionStatus::ActionType::None, 0, "" };
     }
 }
 
 
 void Core::addTransactionOutput(const base::Sha256& tx, const TransactionStatus& status)
 {
-    {
-        std::unique_lock lk(_tx_outputs_mutex);
-        if (auto it = _tx_outputs.find(tx); it != _tx_outputs.end()) {
-            it->second = status;
-        }
-        else {
-            _tx_outputs.insert({ tx, status });
-        }
-    }
+    _tx_outputs_cache.put(tx, status);
     _event_transaction_status_update.notify(tx);
 }
 
 
+void Core::storeBlockOutputs(const ImmutableBlock& block, const BlockOutputs& outputs)
+{
+    _blockchain.pushForwardToPersistentStorage(block, outputs);
+    for (const auto& [tx_hash, status] : outputs.statuses) {
+        _tx_outputs_cache.put(tx_hash, status);
+    }
+}
+
+
 Blockchain::AdditionResult Core::tryAddBlock(const ImmutableBlock& b)
 {
+    if (!_signature_verifier.verifyAll(b.getTransactions())) {
+        LOG_DEBUG << "Block #" << b.getDepth() << " has transactions with invalid signatures";
+        return Blockchain::AdditionResult::INVALID_TRANSACTIONS;
+    }
+
     {
         std::lock_guard lk{ _blockchain_mutex };
         if (auto r = _tryAddBlock(b); r != Blockchain::AdditionResult::ADDED) {
@@ -181,6 +426,11 @@ Blockchain::AdditionResult Core::tryAddBlock(const ImmutableBlock& b)
 
 Blockchain::AdditionResult Core::tryAddMinedBlock(const ImmutableBlock& b)
 {
+    // transactions of a mined block came from the pending set, so their signatures are already verified
+    if (!_signature_verifier.verifyAll(b.getTransactions())) {
+        return Blockchain::AdditionResult::INVALID_TRANSACTIONS;
+    }
+
     {
         std::lock_guard lk{ _blockchain_mutex };
         if (auto r = _tryAddBlock(b); r != Blockchain::AdditionResult::ADDED) {
@@ -188,6 +438,7 @@ Blockchain::AdditionResult Core::tryAddMinedBlock(const ImmutableBlock& b)
         }
     }
 
+    _event_block_added.notify(b);
     _event_block_mined.notify(b);
 
     return Blockchain::AdditionResult::ADDED;
@@ -203,17 +454,33 @@ Blockchain::AdditionResult Core::_tryAddBlock(const ImmutableBlock& b)
     }
 
     if (auto r = _blockchain.tryAddBlock(b); r != Blockchain::AdditionResult::ADDED) {
+        LOG_DEBUG << b.getHash() << " is not added with reason " << static_cast<int>(r);
         return r;
     }
 
+    std::vector<lk::Transaction> expired;
     {
-        std::shared_lock lk(_pending_transactions_mutex);
-        _pending_transactions.remove(b.getTransactions());
+        std::unique_lock lk(_pending_transactions_mutex);
+        _mempool.remove(b.getTransactions());
+        expired = _mempool.removeExpired(base::Time::now());
     }
+    notifyDroppedTransactions(expired, MEMPOOL_EXPIRED_MESSAGE);
 
     LOG_DEBUG << "Applying transactions from block #" << b.getDepth();
 
-    applyBlockTransactions(b);
+    auto outputs = applyBlockTransactions(b);
+    storeBlockOutputs(b, outputs);
+    for (const auto& output : outputs.statuses) {
+        _event_transaction_status_update.notify(output.first);
+    }
+
+    if (b.getDepth() % _state_snapshot_interval == 0) {
+        saveStateSnapshot(b);
+        const auto cache_stats = getBlocksCacheStats();
+        LOG_INFO << "Blocks cache at block #" << b.getDepth() << ": " << cache_stats.size << " blocks, "
+                 << cache_stats.weight << "/" << cache_stats.capacity << " bytes, " << cache_stats.hits << " hits, "
+                 << cache_stats.misses << " misses";
+    }
     return Blockchain::AdditionResult::ADDED;
 }
 
@@ -224,6 +491,12 @@ std::optional<ImmutableBlock> Core::findBlock(const base::Sha256& hash) const
 }
 
 
+std::optional<BlockHeader> Core::findBlockHeader(const base::Sha256& hash) const
+{
+    return _blockchain.findBlockHeader(hash);
+}
+
+
 std::optional<base::Sha256> Core::findBlockHash(const lk::BlockDepth& depth) const
 {
     return _blockchain.findBlockHashByDepth(depth);
@@ -245,7 +518,7 @@ std::optional<lk::Transaction> Core::findTransaction(const base::Sha256& hash) c
  */
 bool Core::checkBlockTransactions(const ImmutableBlock& block) const
 {
-    if (_blockchain.findBlock(base::Sha256::compute(base::toBytes(block)))) {
+    if (_blockchain.findBlockHeader(block.getHash())) {
         return false;
     }
 
@@ -255,23 +528,19 @@ bool Core::checkBlockTransactions(const ImmutableBlock& block) const
 
 std::pair<MutableBlock, lk::Complexity> Core::getMiningData() const
 {
-    std::unique_lock lk{ _blockchain_mutex };
+    std::shared_lock lk{ _blockchain_mutex };
 
     const auto& p = _blockchain.getTopBlockAndComplexity();
     const auto& top_block = p.first;
     auto& complexity = p.second;
 
     lk::BlockDepth depth = top_block.getDepth() + 1;
-    auto prev_hash = base::Sha256::compute(base::toBytes(top_block));
+    auto prev_hash = top_block.getHash();
 
     TransactionsSet pending;
     {
         std::shared_lock lk(_pending_transactions_mutex);
-        pending = _pending_transactions;
-    }
-
-    if (pending.size() > base::config::BC_MAX_TRANSACTIONS_IN_BLOCK) {
-        pending.selectBestByFee(base::config::BC_MAX_TRANSACTIONS_IN_BLOCK);
+        pending = _mempool.getBlockTransactions();
     }
 
     BlockBuilder b;
@@ -295,6 +564,20 @@ lk::AccountInfo Core::getAccountInfo(const lk::Address& address) const
 }
 
 
+std::vector<base::Sha256> Core::getAccountTransactions(const lk::Address& address,
+                                                       std::uint64_t first_sequence_number,
+                                                       std::size_t count) const
+{
+    return _blockchain.findAccountTransactions(address, first_sequence_number, count);
+}
+
+
+Blockchain::BlocksCacheStats Core::getBlocksCacheStats() const
+{
+    return _blockchain.getBlocksCacheStats();
+}
+
+
 ImmutableBlock Core::getTopBlock() const
 {
     return _blockchain.getTopBlock();
@@ -313,21 +596,31 @@ const lk::Address& Core::getThisNodeAddress() const noexcept
 }
 
 
-void Core::applyBlockTransactions(const ImmutableBlock& block)
+BlockOutputs Core::applyBlockTransactions(const ImmutableBlock& block)
 {
     static constexpr lk::Balance EMISSION_VALUE{ base::config::BC_EMISSION_VALUE };
     _state_manager.applyBlockEmission(block.getCoinbase(), EMISSION_VALUE);
+
+    BlockOutputs outputs;
+    outputs.statuses.reserve(block.getTransactions().size());
+    outputs.accounts_transactions.reserve(block.getTransactions().size());
     for (const auto& tx : block.getTransactions()) {
-        tryPerformTransaction(tx, block);
+        auto tx_hash = tx.hashOfTransaction();
+        auto sequence_number = _state_manager.registerTransaction(tx.getFrom());
+        outputs.accounts_transactions.push_back(AccountTransaction{ tx.getFrom(), sequence_number, tx_hash });
+
+        auto status = tryPerformTransaction(tx, block);
+        outputs.statuses.emplace_back(std::move(tx_hash), std::move(status));
     }
+    outputs.contracts_code = _state_manager.takeNewContractsCode();
+    return outputs;
 }
 
 
-void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock& block_where_tx)
+TransactionStatus Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock& block_where_tx)
 {
     auto transaction_hash = tx.hashOfTransaction();
     LOG_DEBUG << "Performing transactions with hash " << transaction_hash;
-    _state_manager.addTxHash(tx.getFrom(), transaction_hash);
     auto commit = _state_manager.createCommit();
 
     if (tx.getTo() == lk::Address::null()) {
@@ -340,14 +633,14 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                          TransactionStatus::ActionType::ContractCreation,
                                          tx.getFee(),
                                          {});
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
 
             auto eval_result = callInitContractVm(commit, block_where_tx, tx, contract_address, tx.getData());
 
             if (eval_result.status_code == evmc_status_code::EVMC_SUCCESS) {
                 auto runtime_code = vm::copy(eval_result.output_data, eval_result.output_size);
-                commit.setRuntimeCode(contract_address, runtime_code);
+                commit.setRuntimeCode(contract_address, std::move(runtime_code));
                 LOG_DEBUG << "Deployed contract to address "
                           << base::base58Encode(contract_address.getBytes().toBytes());
 
@@ -358,7 +651,7 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                          TransactionStatus::ActionType::ContractCreation,
                                          eval_result.gas_left,
                                          base::base58Encode(contract_address.getBytes()));
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
             else if (eval_result.status_code == evmc_status_code::EVMC_REVERT) {
                 _state_manager.payFee(tx.getFrom(), block_where_tx.getCoinbase(), tx.getFee() - eval_result.gas_left);
@@ -367,7 +660,7 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                          TransactionStatus::ActionType::ContractCreation,
                                          eval_result.gas_left,
                                          {});
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
             else {
                 _state_manager.payFee(tx.getFrom(), block_where_tx.getCoinbase(), tx.getFee() - eval_result.gas_left);
@@ -376,14 +669,14 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                          TransactionStatus::ActionType::ContractCreation,
                                          eval_result.gas_left,
                                          {});
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
             ASSERT(false);
         }
         catch (const base::Error&) {
             TransactionStatus status(
               TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::ContractCreation, tx.getFee(), {});
-            return addTransactionOutput(transaction_hash, status);
+            return status;
         }
         ASSERT(false);
     }
@@ -395,7 +688,7 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::ContractCall,
                                              tx.getFee(),
                                              {});
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
 
                 if (tx.getAmount() > 0 && !commit.tryTransferMoney(tx.getFrom(), tx.getTo(), tx.getAmount())) {
@@ -403,11 +696,11 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::ContractCall,
                                              tx.getFee(),
                                              {});
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
 
                 auto code = commit.getRuntimeCode(tx.getTo());
-                auto eval_result = callContractVm(commit, block_where_tx, tx, code, tx.getData());
+                auto eval_result = callContractVm(commit, block_where_tx, tx, *code, tx.getData());
 
                 if (eval_result.status_code == evmc_status_code::EVMC_SUCCESS) {
                     auto output_data = vm::copy(eval_result.output_data, eval_result.output_size);
@@ -423,7 +716,7 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::ContractCall,
                                              eval_result.gas_left,
                                              base::toHex(output_data));
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
                 else if (eval_result.status_code == evmc_status_code::EVMC_REVERT) {
                     _state_manager.payFee(
@@ -433,7 +726,7 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::ContractCall,
                                              eval_result.gas_left,
                                              {});
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
                 else {
                     _state_manager.payFee(
@@ -443,14 +736,13 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::ContractCall,
                                              eval_result.gas_left,
                                              {});
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
             }
             catch (const base::Error&) {
                 TransactionStatus status(
                   TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::ContractCall, tx.getFee(), {});
-                addTransactionOutput(transaction_hash, status);
-                return;
+                return status;
             }
         }
         else {
@@ -461,25 +753,26 @@ void Core::tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock
                                              TransactionStatus::ActionType::Transfer,
                                              tx.getFee(),
                                              {});
-                    return addTransactionOutput(transaction_hash, status);
+                    return status;
                 }
                 _state_manager.applyCommit(std::move(commit));
 
                 TransactionStatus status(
                   TransactionStatus::StatusCode::Success, TransactionStatus::ActionType::Transfer, 0, {});
 
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
             catch (const base::Error& er) {
                 TransactionStatus status(
                   TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::Transfer, tx.getFee(), {});
 
-                return addTransactionOutput(transaction_hash, status);
+                return status;
             }
         }
         ASSERT(false);
     }
     ASSERT(false);
+    return TransactionStatus{ TransactionStatus::StatusCode::Failed, TransactionStatus::ActionType::None, tx.getFee() };
 }
 
 
@@ -539,9 +832,9 @@ evmc::result Core::callVm(Commit& current_commit,
 }
 
 
-void Core::subscribeToBlockAddition(decltype(Core::_event_block_mined)::CallbackType callback)
+void Core::subscribeToBlockAddition(decltype(Core::_event_block_added)::CallbackType callback)
 {
-    _event_block_mined.subscribe(std::move(callback));
+    _event_block_added.subscribe(std::move(callback));
 }
 
 
@@ -557,6 +850,12 @@ void Core::subscribeToNewPendingTransaction(decltype(Core::_event_new_pending_tr
 }
 
 
+void Core::subscribeToNewPendingTransactions(decltype(Core::_event_new_pending_transactions)::CallbackType callback)
+{
+    _event_new_pending_transactions.subscribe(std::move(callback));
+}
+
+
 void Core::subscribeToAnyTransactionStatusUpdate(
   decltype(Core::_event_transaction_status_update)::CallbackType callback)
 {
@@ -597,14 +896,12 @@ bool EthHost::account_exists(const evmc::address& addr) const noexcept
 
 evmc::bytes32 EthHost::get_storage(const evmc::address& addr, const evmc::bytes32& ethKey) const noexcept
 {
-
+    // storage is accessed by every SLOAD, so nothing is allocated here, including the address for logging
     LOG_DEBUG << "Core::get_storage";
     try {
         auto address = vm::toNativeAddress(addr);
-        LOG_DEBUG << "Core::get_storage from address " << base::base58Encode(address.getBytes().toBytes());
-        base::Bytes key(ethKey.bytes, 32);
         if (_current_commit.hasAccount(address)) {
-            auto storage_value = _current_commit.getStorageValue(address, base::Sha256(key)).data;
+            auto storage_value = _current_commit.getStorageValue(address, vm::toStorageSlot(ethKey));
             return vm::toEvmcBytes32(storage_value);
         }
         return {};
@@ -621,13 +918,13 @@ evmc_storage_status EthHost::set_storage(const evmc::address& addr,
 {
     LOG_DEBUG << "Core::set_storage";
     try {
-        static const base::Bytes NULL_VALUE(32);
+        static const lk::StorageSlot NULL_VALUE;
         auto address = vm::toNativeAddress(addr);
-        LOG_DEBUG << "Core::set_storage to address " << base::base58Encode(address.getBytes().toBytes());
-        auto key = base::Sha256(base::Bytes(ekey.bytes, 32));
-        base::Bytes new_value(evalue.bytes, 32);
+        auto key = vm::toStorageSlot(ekey);
+        auto new_value = vm::toStorageSlot(evalue);
 
-        if (!_current_commit.checkStorageValue(address, key)) {
+        auto old_value = _current_commit.findStorageValue(address, key);
+        if (!old_value) {
             if (new_value == NULL_VALUE) {
                 return evmc_storage_status::EVMC_STORAGE_UNCHANGED;
             }
@@ -637,14 +934,12 @@ evmc_storage_status EthHost::set_storage(const evmc::address& addr,
             }
         }
         else {
-            auto old_storage_data = _current_commit.getStorageValue(address, key);
-            const auto& old_value = old_storage_data.data;
-
-            _current_commit.setStorageValue(address, key, new_value);
-            if (old_value == new_value) {
+            if (*old_value == new_value) {
                 return evmc_storage_status::EVMC_STORAGE_UNCHANGED;
             }
-            else if (new_value == NULL_VALUE) {
+
+            _current_commit.setStorageValue(address, key, new_value);
+            if (new_value == NULL_VALUE) {
                 return evmc_storage_status::EVMC_STORAGE_DELETED;
             }
             else {
@@ -683,10 +978,7 @@ size_t EthHost::get_code_size(const evmc::address& addr) const noexcept
         auto address = vm::toNativeAddress(addr);
         LOG_DEBUG << "Core::get_code_size to address " << base::base58Encode(address.getBytes().toBytes());
 
-        if (_current_commit.hasAccount(address)) {
-            return _current_commit.getCodeSize(address);
-        }
-        return 0;
+        return getCode(address)->size();
     }
     catch (...) { // cannot pass exceptions since noexcept
         return 0;
@@ -718,12 +1010,12 @@ size_t EthHost::copy_code(const evmc::address& addr,
     try {
         auto address = vm::toNativeAddress(addr);
         LOG_DEBUG << "Core::copy_code to address " << base::base58Encode(address.getBytes().toBytes());
-        if (auto code = _current_commit.getRuntimeCode(address); code.isEmpty()) {
+        if (auto code = getCode(address); code_offset >= code->size()) {
             return 0;
         }
         else {
-            std::size_t bytes_to_copy = std::min(buffer_size, code.size() - code_offset);
-            std::copy_n(code.getData() + code_offset, bytes_to_copy, buffer_data);
+            std::size_t bytes_to_copy = std::min(buffer_size, code->size() - code_offset);
+            std::copy_n(code->getData() + code_offset, bytes_to_copy, buffer_data);
             return bytes_to_copy;
         }
     }
@@ -755,8 +1047,8 @@ evmc::result EthHost::call(const evmc_message& msg) noexcept
         lk::Address to = vm::toNativeAddress(msg.destination);
         LOG_DEBUG << "Core::call to address " << base::base58Encode(to.getBytes().toBytes());
         if (_current_commit.hasAccount(to) && _current_commit.getAccountType(to) == lk::AccountType::CONTRACT) {
-            const auto& code = _current_commit.getRuntimeCode(to);
-            return _core.callVm(_current_commit, _associated_block, _associated_tx, msg, code);
+            auto code = getCode(to);
+            return _core.callVm(_current_commit, _associated_block, _associated_tx, msg, *code);
         }
         else {
             lk::Address from = vm::toNativeAddress(msg.sender);
@@ -820,4 +1112,23 @@ void EthHost::emit_log([[maybe_unused]] const evmc::address&,
 }
 
 
+lk::ContractCode EthHost::getCode(const lk::Address& address) const
+{
+    static const lk::ContractCode empty_code = std::make_shared<const base::Bytes>();
+    if (auto cached_code = _code_cache.find(address)) {
+        return *cached_code;
+    }
+    if (!_current_commit.hasAccount(address)) {
+        return empty_code;
+    }
+
+    auto code = _current_commit.getRuntimeCode(address);
+    // code doesn't change once set, while an account without code can still get it in this frame
+    if (!code->isEmpty()) {
+        _code_cache.insert(address, code);
+    }
+    return code;
+}
+
+
 } // namespace core
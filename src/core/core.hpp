@@ -6,6 +6,8 @@
 #include "core/blockchain.hpp"
 #include "core/host.hpp"
 #include "core/managers.hpp"
+#include "core/mempool.hpp"
+#include "core/signature_verifier.hpp"
 
 #include "vm/vm.hpp"
 
@@ -40,8 +42,13 @@ class Core
     void run();
     //==================
     lk::AccountInfo getAccountInfo(const lk::Address& address) const;
+    std::vector<base::Sha256> getAccountTransactions(const lk::Address& address,
+                                                     std::uint64_t first_sequence_number,
+                                                     std::size_t count) const;
     //==================
     void addPendingTransaction(const lk::Transaction& tx);
+    // admits all transactions under one lock of the pending set and gives their statuses in the same order
+    std::vector<TransactionStatus> addPendingTransactions(const std::vector<lk::Transaction>& txs);
     //==================
     std::optional<TransactionStatus> getTransactionOutput(const base::Sha256& tx_hash);
     void addTransactionOutput(const base::Sha256& tx, const TransactionStatus& status);
@@ -50,10 +57,12 @@ class Core
     Blockchain::AdditionResult tryAddMinedBlock(const ImmutableBlock& b);
     //==================
     std::optional<ImmutableBlock> findBlock(const base::Sha256& hash) const;
+    std::optional<BlockHeader> findBlockHeader(const base::Sha256& hash) const;
     std::optional<base::Sha256> findBlockHash(const lk::BlockDepth& depth) const;
     std::optional<lk::Transaction> findTransaction(const base::Sha256& hash) const;
     ImmutableBlock getTopBlock() const;
     base::Sha256 getTopBlockHash() const;
+    Blockchain::BlocksCacheStats getBlocksCacheStats() const;
     //==================
     std::pair<MutableBlock, lk::Complexity> getMiningData() const;
     //==================
@@ -68,10 +77,15 @@ class Core
     base::Observable<const lk::ImmutableBlock&> _event_block_added;
     base::Observable<const lk::ImmutableBlock&> _event_block_mined;
     base::Observable<const lk::Transaction&> _event_new_pending_transaction;
+    base::Observable<const lk::TransactionsSet&> _event_new_pending_transactions;
     base::Observable<base::Sha256> _event_transaction_status_update;
     base::Observable<lk::Address> _event_account_update;
     //==================
     StateManager _state_manager;
+    const lk::BlockDepth _state_snapshot_interval;
+
+    // signatures of block transactions are checked before _blockchain_mutex is taken
+    SignatureVerifier _signature_verifier;
 
     mutable std::shared_mutex _blockchain_mutex;
     PersistentBlockchain _blockchain;
@@ -82,19 +96,24 @@ class Core
     //==================
     evmc::VM _vm;
     //==================
-    lk::TransactionsSet _pending_transactions;
+    lk::Mempool _mempool;
     mutable std::shared_mutex _pending_transactions_mutex;
     //================
-    std::unordered_map<base::Sha256, TransactionStatus> _tx_outputs;
-    mutable std::shared_mutex _tx_outputs_mutex;
+    // statuses of transactions from blocks are stored in database, this cache also keeps statuses of pending ones
+    base::LruCache<base::Sha256, TransactionStatus> _tx_outputs_cache;
     //==================
     static const ImmutableBlock& getGenesisBlock();
-    void applyBlockTransactions(const ImmutableBlock& block);
+    BlockOutputs applyBlockTransactions(const ImmutableBlock& block);
+    void storeBlockOutputs(const ImmutableBlock& block, const BlockOutputs& outputs);
+    void restoreState();
+    // reports transactions dropped from the mempool through the transaction status update
+    void notifyDroppedTransactions(const std::vector<lk::Transaction>& txs, const std::string& reason);
+    void saveStateSnapshot(const ImmutableBlock& block);
     //==================
     // Only called from tryAddBlock -- just a helper function, not thread safe
     bool checkBlockTransactions(const ImmutableBlock& block) const;
     //==================
-    void tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock& block_where_tx);
+    TransactionStatus tryPerformTransaction(const lk::Transaction& tx, const ImmutableBlock& block_where_tx);
     //==================
     void on_account_updated(lk::Address address);
     //==================
@@ -116,8 +135,9 @@ class Core
 
   public:
     //==================
-    // notifies if new blocks are added: genesis and blocks, that are stored in DB, are not handled by this
-    void subscribeToBlockAddition(decltype(_event_block_mined)::CallbackType callback);
+    // notifies if new blocks are added, either received or mined: genesis and blocks, that are stored in DB,
+    // are not handled by this
+    void subscribeToBlockAddition(decltype(_event_block_added)::CallbackType callback);
 
     // notifies if a block was mined by this node and it was added to blockchain
     void subscribeToBlockMining(decltype(_event_block_mined)::CallbackType callback);
@@ -125,6 +145,9 @@ class Core
     // notifies if some transaction was added to set of pending
     void subscribeToNewPendingTransaction(decltype(_event_new_pending_transaction)::CallbackType callback);
 
+    // notifies once per batch of transactions added to set of pending
+    void subscribeToNewPendingTransactions(decltype(_event_new_pending_transactions)::CallbackType callback);
+
     // notifies if any transaction status was updated
     void subscribeToAnyTransactionStatusUpdate(decltype(_event_transaction_status_update)::CallbackType callback);
 
@@ -176,6 +199,10 @@ class EthHost : public evmc::Host
     Commit& _current_commit;
     const ImmutableBlock& _associated_block;
     const Transaction& _associated_tx;
+    // a contract reads code of the same accounts again and again, so it's looked up once per call frame
+    mutable AddressTable<lk::ContractCode> _code_cache;
+
+    lk::ContractCode getCode(const lk::Address& address) const;
 };
 
 } // namespace core
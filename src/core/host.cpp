@@ -450,6 +450,16 @@ void Host::broadcast(const Transaction& tx)
 }
 
 
+void Host::broadcast(const TransactionsSet& txs)
+{
+    _handshaked_peers.forEachPeer([&txs](Peer& peer) {
+        for (const auto& tx : txs) {
+            peer.sendTransaction(tx);
+        }
+    });
+}
+
+
 bool Host::isConnectedTo(const net::Endpoint& endpoint) const
 {
     return _non_handshaked_peers.hasPeerWithEndpoint(endpoint) || _handshaked_peers.hasPeerWithEndpoint(endpoint);
@@ -125,6 +125,7 @@ class Host
     void broadcast(const ImmutableBlock& block);
     void broadcastNewBlock(const ImmutableBlock& block);
     void broadcast(const lk::Transaction& tx);
+    void broadcast(const lk::TransactionsSet& txs);
     //=================================
     void run();
     void join();
@@ -12,6 +12,77 @@ AccountState::AccountState(AccountType initial_type)
 {}
 
 
+AccountState::AccountState(const AccountState& other)
+  : type{ other.type }
+  , nonce{ other.nonce }
+  , balance{ other.balance }
+  , code_hash{ other.code_hash }
+  , _contract_data{ other._contract_data ? std::make_unique<ContractData>(*other._contract_data) : nullptr }
+{}
+
+
+AccountState& AccountState::operator=(const AccountState& other)
+{
+    if (this != &other) {
+        *this = AccountState{ other };
+    }
+    return *this;
+}
+
+
+const ContractData& AccountState::getContractData() const
+{
+    static const ContractData empty;
+    return _contract_data ? *_contract_data : empty;
+}
+
+
+ContractData& AccountState::getContractData()
+{
+    if (!_contract_data) {
+        _contract_data = std::make_unique<ContractData>();
+    }
+    return *_contract_data;
+}
+
+
+AccountState AccountState::deserialize(base::SerializationIArchive& ia)
+{
+    AccountState ret{ ia.deserialize<AccountType>() };
+    ret.nonce = ia.deserialize<std::uint64_t>();
+    ret.balance = ia.deserialize<lk::Balance>();
+    ret.code_hash = ia.deserialize<base::Sha256>();
+
+    ContractData contract_data;
+    auto storage_size = ia.deserialize<std::size_t>();
+    for (std::size_t i = 0; i < storage_size; ++i) {
+        auto key = ia.deserialize<StorageSlot>();
+        contract_data.storage.insert(key, ia.deserialize<StorageSlot>());
+    }
+
+    if (!contract_data.storage.isEmpty()) {
+        ret.getContractData() = std::move(contract_data);
+    }
+    return ret;
+}
+
+
+void AccountState::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serialize(type);
+    oa.serialize(nonce);
+    oa.serialize(balance);
+    oa.serialize(code_hash);
+
+    const auto& contract_data = getContractData();
+    oa.serialize(contract_data.storage.size());
+    contract_data.storage.forEach([&oa](const StorageSlot& key, const StorageSlot& value) {
+        oa.serialize(key);
+        oa.serialize(value);
+    });
+}
+
+
 Commit::Commit(StateManager& state_manager)
   : _state_manager{ state_manager }
 {}
@@ -19,7 +90,7 @@ Commit::Commit(StateManager& state_manager)
 Commit::Commit(Commit&& another)
   : _state_manager{ another._state_manager }
 {
-    _changed_states = std::move(another._changed_states);
+    _changes = std::move(another._changes);
     _deleted_accounts = std::move(another._deleted_accounts);
 }
 
@@ -27,7 +98,7 @@ Commit::Commit(Commit&& another)
 Commit& Commit::operator=(Commit&& another)
 {
     std::scoped_lock lock{ _rw_mutex, another._rw_mutex };
-    _changed_states = std::move(another._changed_states);
+    _changes = std::move(another._changes);
     _deleted_accounts = std::move(another._deleted_accounts);
     return *this;
 }
@@ -43,21 +114,22 @@ bool Commit::createClientAccount(const lk::Address& address)
 lk::Address Commit::createContractAccount(const lk::Address& from_account_address, base::Sha256 associated_code_hash)
 {
     std::unique_lock lock{ _rw_mutex };
-    if (!_hasAccountAnywhere(from_account_address)) {
+    if (!_hasAccount(from_account_address)) {
         RAISE_ERROR(base::LogicError, "address already exists");
     }
 
 
-    auto& account = _getAccountAnywhere(from_account_address);
+    auto& account = _getBaseAccount(from_account_address);
     base::Bytes nonce_string_data{ std::to_string(account.nonce) };
 
     auto bytes_address = base::Ripemd160::compute(associated_code_hash.getBytes().toBytes() +
                                                   from_account_address.getBytes().toBytes() + nonce_string_data);
     auto account_address = lk::Address(bytes_address.getBytes());
 
-    AccountState state{ AccountType::CONTRACT };
-    state.code_hash = std::move(associated_code_hash);
-    _changed_states.insert({ account_address, std::move(state) });
+    AccountChanges changes;
+    // the code hash is set together with the runtime code, when the contract is initialized
+    changes.created = std::make_unique<AccountState>(AccountType::CONTRACT);
+    _changes.insert(account_address, std::move(changes));
 
     return account_address;
 }
@@ -66,25 +138,20 @@ lk::Address Commit::createContractAccount(const lk::Address& from_account_addres
 bool Commit::hasAccount(const lk::Address& address) const
 {
     std::shared_lock lock{ _rw_mutex };
-    return _hasAccountAnywhere(address);
+    return _hasAccount(address);
 }
 
 
 bool Commit::deleteAccount(const lk::Address& address, const lk::Address& beneficiary_address)
 {
     std::unique_lock lock{ _rw_mutex };
-    if (!_hasAccountAnywhere(address)) {
+    if (!_hasAccount(address)) {
         return false;
     }
-    auto value = _getAccountAnywhere(address).balance;
-    if (!tryTransferMoney(address, beneficiary_address, value)) {
+    if (!_tryTransferMoney(address, beneficiary_address, _getBalance(address))) {
         return false;
     }
-
-    {
-        std::unique_lock lock{ _rw_mutex };
-        _deleted_accounts.insert(address);
-    }
+    _deleted_accounts.insert(address);
 
     return false;
 }
@@ -93,209 +160,184 @@ bool Commit::deleteAccount(const lk::Address& address, const lk::Address& benefi
 AccountType Commit::getAccountType(const lk::Address& account_address) const
 {
     std::shared_lock lock{ _rw_mutex };
-    return _getAccountAnywhere(account_address).type;
+    return _getBaseAccount(account_address).type;
 }
 
 
 bool Commit::tryTransferMoney(const lk::Address& from, const lk::Address& to, const lk::Balance& amount)
 {
     std::unique_lock lock{ _rw_mutex };
-    if (!_hasAccountAnywhere(from)) {
-        return false;
-    }
-    _copyLocalIfNotExists(from);
-
-    if (!_hasAccountAnywhere(to)) {
-        ASSERT(_createClientAccount(to));
-    }
-    else {
-        _copyLocalIfNotExists(to);
-    }
-
-    auto& from_account = _getAccount(from);
-    if (from_account.balance < amount) {
-        return false;
-    }
-    auto& to_account = _getAccount(to);
-
-    from_account.balance -= amount;
-    to_account.balance += amount;
-    return true;
+    return _tryTransferMoney(from, to, amount);
 }
 
 
-bool Commit::checkStorageValue(const lk::Address& contract_address, const base::Sha256& key) const
+std::optional<StorageSlot> Commit::findStorageValue(const lk::Address& contract_address, const StorageSlot& key) const
 {
     std::shared_lock lock{ _rw_mutex };
-    if (!_hasAccountAnywhere(contract_address)) {
-        RAISE_ERROR(base::LogicError, "account address was not found by a given key");
-    }
-
-    const auto& account = _getAccountAnywhere(contract_address);
-    if (account.type != AccountType::CONTRACT) {
-        RAISE_ERROR(base::LogicError, "account is not a contract type");
+    _getContractBaseAccount(contract_address);
+    if (auto value = _findStorageValue(contract_address, key)) {
+        return *value;
     }
-
-    return account.storage.contains(key);
+    return std::nullopt;
 }
 
 
-const StorageData& Commit::getStorageValue(const lk::Address& contract_address, const base::Sha256& key) const
+StorageSlot Commit::getStorageValue(const lk::Address& contract_address, const StorageSlot& key) const
 {
-    std::shared_lock lock{ _rw_mutex };
-    if (!_hasAccountAnywhere(contract_address)) {
-        RAISE_ERROR(base::LogicError, "account address was not found by a given key");
-    }
-
-    const auto& account = _getAccountAnywhere(contract_address);
-    if (account.type != AccountType::CONTRACT) {
-        RAISE_ERROR(base::LogicError, "account is not a contract type");
-    }
-
-    if (auto it = account.storage.find(key); it == account.storage.end()) {
-        RAISE_ERROR(base::LogicError, "value was not found by a given key");
-    }
-    else {
-        return it->second;
-    }
+    return findStorageValue(contract_address, key).value_or(StorageSlot{});
 }
 
 
-void Commit::setStorageValue(const lk::Address& contract_address, const base::Sha256& key, base::Bytes value)
+void Commit::setStorageValue(const lk::Address& contract_address, const StorageSlot& key, const StorageSlot& value)
 {
-    std::shared_lock lock{ _rw_mutex };
-    if (!_copyLocalIfNotExists(contract_address)) {
-        RAISE_ERROR(base::LogicError, "account address was not found by a given key");
-    }
-    auto& account = _getAccount(contract_address);
-    if (account.type != AccountType::CONTRACT) {
-        RAISE_ERROR(base::LogicError, "account is not a contract type");
-    }
-
-    StorageData& sd = account.storage[key];
-    sd.data = std::move(value);
-    sd.was_modified = true;
+    std::unique_lock lock{ _rw_mutex };
+    _getContractBaseAccount(contract_address);
+    _getChanges(contract_address).storage.insertOrAssign(key, value);
 }
 
 
 lk::Balance Commit::getBalance(const lk::Address& account_address) const
 {
     std::shared_lock lock{ _rw_mutex };
-    return _getAccountAnywhere(account_address).balance;
+    return _getBalance(account_address);
 }
 
 
 std::size_t Commit::getCodeSize(const lk::Address& account_address) const
 {
-    std::shared_lock lock{ _rw_mutex };
-    return _getAccountAnywhere(account_address).runtime_code.size();
+    return getRuntimeCode(account_address)->size();
 }
 
 
 const base::Sha256& Commit::getCodeHash(const lk::Address& account_address) const
 {
     std::shared_lock lock{ _rw_mutex };
-    return _getAccountAnywhere(account_address).code_hash;
+    const auto& base_account = _getBaseAccount(account_address);
+    if (auto changes = _changes.find(account_address); changes && changes->runtime_code) {
+        return changes->runtime_code_hash;
+    }
+    return base_account.code_hash;
 }
 
 
-const base::Bytes& Commit::getRuntimeCode(const lk::Address& account_address) const
+ContractCode Commit::getRuntimeCode(const lk::Address& account_address) const
 {
     std::shared_lock lock{ _rw_mutex };
-    return _getAccountAnywhere(account_address).runtime_code;
+    const auto& base_account = _getBaseAccount(account_address);
+    if (auto changes = _changes.find(account_address); changes && changes->runtime_code) {
+        return changes->runtime_code;
+    }
+    return _state_manager._code_store.find(base_account.code_hash);
 }
 
 
-void Commit::setRuntimeCode(const lk::Address& contract_address, const base::Bytes& code)
+void Commit::setRuntimeCode(const lk::Address& contract_address, base::Bytes code)
 {
-    std::shared_lock lock{ _rw_mutex };
-    if (!_copyLocalIfNotExists(contract_address)) {
-        RAISE_ERROR(base::LogicError, "account address was not found by a given key");
-    }
-    auto& account = _getAccount(contract_address);
-    if (account.type != AccountType::CONTRACT) {
-        RAISE_ERROR(base::LogicError, "account is not a contract type");
-    }
-
-    account.runtime_code = code;
+    std::unique_lock lock{ _rw_mutex };
+    _getContractBaseAccount(contract_address);
+    auto& changes = _getChanges(contract_address);
+    changes.runtime_code_hash = code.isEmpty() ? base::Sha256::null() : base::Sha256::compute(code);
+    changes.runtime_code = std::make_shared<const base::Bytes>(std::move(code));
 }
 
 
-AccountState& Commit::_getAccount(const lk::Address& account_address)
+const AccountState* Commit::_findBaseAccount(const lk::Address& address) const
 {
-    auto it = _changed_states.find(account_address);
-    if (it == _changed_states.end()) {
-        RAISE_ERROR(base::InvalidArgument, "cannot getAccount for non-existent account");
-    }
-    else {
-        return it->second;
+    if (auto changes = _changes.find(address); changes && changes->created) {
+        return changes->created.get();
     }
+    return _state_manager._states.find(address);
 }
 
 
-const AccountState& Commit::_getAccount(const lk::Address& account_address) const
+const AccountState& Commit::_getBaseAccount(const lk::Address& address) const
 {
-    auto it = _changed_states.find(account_address);
-    if (it == _changed_states.end() || _deleted_accounts.contains(account_address)) {
+    auto account = _findBaseAccount(address);
+    if (!account) {
         RAISE_ERROR(base::InvalidArgument, "cannot getAccount for non-existent account");
     }
-    else {
-        return it->second;
-    }
+    return *account;
 }
 
 
-const AccountState& Commit::_getAccountAnywhere(const lk::Address& account_address) const
+const AccountState& Commit::_getContractBaseAccount(const lk::Address& address) const
 {
-    auto it = _changed_states.find(account_address);
-    if (it == _changed_states.end() || _deleted_accounts.contains(account_address)) {
-        return _state_manager._getAccount(account_address);
+    auto account = _findBaseAccount(address);
+    if (!account) {
+        RAISE_ERROR(base::LogicError, "account address was not found by a given key");
     }
-    else {
-        return it->second;
+    if (account->type != AccountType::CONTRACT) {
+        RAISE_ERROR(base::LogicError, "account is not a contract type");
     }
+    return *account;
 }
 
 
-bool Commit::_hasAccountThis(const lk::Address& address) const
+bool Commit::_hasAccount(const lk::Address& address) const
 {
-    return _changed_states.contains(address) && !_deleted_accounts.contains(address);
+    return _findBaseAccount(address) && !_deleted_accounts.contains(address);
 }
 
 
-bool Commit::_hasAccountRoot(const lk::Address& address) const
+lk::Balance Commit::_getBalance(const lk::Address& address) const
 {
-    return _state_manager.hasAccount(address);
+    auto balance = _getBaseAccount(address).balance;
+    if (auto changes = _changes.find(address)) {
+        balance += changes->credit;
+        balance -= changes->debit;
+    }
+    return balance;
 }
 
 
-bool Commit::_hasAccountAnywhere(const lk::Address& address) const
+const StorageSlot* Commit::_findStorageValue(const lk::Address& address, const StorageSlot& key) const
 {
-    return _hasAccountThis(address) || _hasAccountRoot(address);
+    if (auto changes = _changes.find(address)) {
+        if (auto value = changes->storage.find(key)) {
+            return value;
+        }
+    }
+    if (auto account = _findBaseAccount(address)) {
+        return account->getContractData().storage.find(key);
+    }
+    return nullptr;
 }
 
 
-bool Commit::_copyLocalIfNotExists(const lk::Address& address)
+Commit::AccountChanges& Commit::_getChanges(const lk::Address& address)
 {
-    if (!_hasAccountAnywhere(address)) {
-        return false;
+    if (auto changes = _changes.find(address)) {
+        return *changes;
     }
-    if (!_hasAccountThis(address)) {
-        auto& account = _state_manager._getAccount(address);
-        _changed_states.insert({ address, account });
+    return *_changes.insert(address, AccountChanges{}).first;
+}
+
+
+bool Commit::_createClientAccount(const lk::Address& address)
+{
+    if (_hasAccount(address)) {
+        return false;
     }
+
+    AccountChanges changes;
+    changes.created = std::make_unique<AccountState>(AccountType::CLIENT);
+    _changes.insertOrAssign(address, std::move(changes));
     return true;
 }
 
 
-bool Commit::_createClientAccount(const lk::Address& address)
+bool Commit::_tryTransferMoney(const lk::Address& from, const lk::Address& to, const lk::Balance& amount)
 {
-    if (_hasAccountAnywhere(address)) {
+    if (!_hasAccount(from) || _getBalance(from) < amount) {
         return false;
     }
+    if (!_hasAccount(to)) {
+        ASSERT(_createClientAccount(to));
+    }
 
-    AccountState state{ AccountType::CLIENT };
-    _changed_states.insert({ address, state });
+    // a reference to changes of one account is not kept while changes of another one are added
+    _getChanges(from).debit += amount;
+    _getChanges(to).credit += amount;
     return true;
 }
 
@@ -303,27 +345,17 @@ bool Commit::_createClientAccount(const lk::Address& address)
 bool StateManager::checkTransaction(const lk::Transaction& tx) const
 {
     std::shared_lock lk(_rw_mutex);
-    if (!_hasAccount(tx.getFrom())) {
-        return false;
-    }
-    return _getAccount(tx.getFrom()).balance >= tx.getAmount() + tx.getFee();
+    auto account = _states.find(tx.getFrom());
+    return account && account->balance >= tx.getAmount() + tx.getFee();
 }
 
 
 bool StateManager::checkTransactionsSet(const lk::TransactionsSet& tx_set) const
 {
     std::shared_lock lk(_rw_mutex);
-    auto block_balance = lk::calcCost(tx_set);
-    for (const auto& tx : tx_set) {
-        if (_hasAccount(tx.getFrom())) {
-            auto current_account_balance = _getBalance(tx.getFrom());
-            auto block_account_cost = block_balance.find(tx.getFrom());
-            ASSERT(block_account_cost != block_balance.end());
-            if (block_account_cost->second > current_account_balance) {
-                return false;
-            }
-        }
-        else {
+    for (const auto& [sender, block_account_cost] : lk::calcCost(tx_set)) {
+        auto account = _states.find(sender);
+        if (!account || block_account_cost > account->balance) {
             return false;
         }
     }
@@ -337,7 +369,7 @@ void StateManager::updateFromGenesis(const ImmutableBlock& block)
     for (const auto& tx : block.getTransactions()) {
         AccountState state{ AccountType::CLIENT };
         state.balance = tx.getAmount();
-        _states.insert({ tx.getTo(), std::move(state) });
+        _states.insert(tx.getTo(), std::move(state));
     }
 }
 
@@ -353,18 +385,40 @@ void StateManager::applyCommit(Commit&& commit)
     std::set<lk::Address> updated_set;
     {
         std::unique_lock lk(_rw_mutex);
-        for (auto& changed_account : commit._changed_states) {
-            auto it = _states.find(changed_account.first);
-            if (it == _states.end()) {
-                _states.insert(changed_account);
+        commit._changes.forEach([this, &updated_set](const lk::Address& address, Commit::AccountChanges& changes) {
+            auto account = _states.find(address);
+            if (changes.created) {
+                if (account) {
+                    _code_store.removeReference(account->code_hash);
+                }
+                account = &_states.insertOrAssign(address, std::move(*changes.created));
             }
-            else {
-                it->second = changed_account.second;
+            if (!account) {
+                // the account was deleted by another commit after this one had been made
+                account = _states.insert(address, AccountState{ AccountType::CLIENT }).first;
             }
 
-            updated_set.insert(changed_account.first);
-        }
+            account->balance += changes.credit;
+            account->balance -= changes.debit;
+            if (!changes.storage.isEmpty()) {
+                auto& storage = account->getContractData().storage;
+                changes.storage.forEach([&storage](const StorageSlot& key, const StorageSlot& value) {
+                    storage.insertOrAssign(key, value);
+                });
+            }
+            if (changes.runtime_code) {
+                // the new code is referenced first, so that the same code isn't dropped in between
+                _code_store.addReference(changes.runtime_code_hash, std::move(changes.runtime_code));
+                _code_store.removeReference(account->code_hash);
+                account->code_hash = changes.runtime_code_hash;
+            }
+
+            updated_set.insert(address);
+        });
         for (auto& deleted_account_address : commit._deleted_accounts) {
+            if (auto account = _states.find(deleted_account_address)) {
+                _code_store.removeReference(account->code_hash);
+            }
             _states.erase(deleted_account_address);
             updated_set.insert(deleted_account_address);
         }
@@ -376,17 +430,17 @@ void StateManager::applyCommit(Commit&& commit)
 }
 
 
-void StateManager::addTxHash(const lk::Address& address, const base::Sha256& tx_hash)
+std::uint64_t StateManager::registerTransaction(const lk::Address& address)
 {
-    std::shared_lock lk(_rw_mutex);
+    std::unique_lock lk(_rw_mutex);
     if (!_hasAccount(address)) {
         ASSERT(_createClientAccount(address));
     }
     auto& account = _getAccount(address);
     ASSERT(account.type == AccountType::CLIENT);
 
-    account.transactions.emplace_back(std::move(tx_hash));
-    ++(account.nonce);
+    // every sent transaction increments the nonce, so it is also the length of the account history
+    return (account.nonce)++;
 }
 
 
@@ -409,13 +463,14 @@ bool StateManager::payFee(const lk::Address& from, const lk::Address& to, const
     if (!_hasAccount(from)) {
         return false;
     }
-    auto& from_account = _getAccount(from);
-    if (from_account.balance < value) {
+    if (_getAccount(from).balance < value) {
         return false;
     }
     if (!_hasAccount(to)) {
         ASSERT(_createClientAccount(to));
     }
+    // taken after the creation, which can move other accounts in the table
+    auto& from_account = _getAccount(from);
     auto& to_account = _getAccount(to);
 
     from_account.balance -= value;
@@ -438,11 +493,11 @@ bool StateManager::hasAccount(const lk::Address& address) const
 AccountInfo StateManager::getAccountInfo(const lk::Address& account_address) const
 {
     std::shared_lock lk(_rw_mutex);
-    if (!_hasAccount(account_address)) {
+    auto account = _states.find(account_address);
+    if (!account) {
         return AccountInfo{ AccountType::CLIENT, lk::Address::null(), {}, {}, {} };
     }
-    const auto& account = _getAccount(account_address);
-    return AccountInfo{ account.type, account_address, account.balance, account.nonce, account.transactions };
+    return AccountInfo{ account->type, account_address, account->balance, account->nonce, account->nonce };
 }
 
 
@@ -453,27 +508,68 @@ lk::Balance StateManager::getBalance(const lk::Address& account_address) const
 }
 
 
+base::Bytes StateManager::takeSnapshot() const
+{
+    base::SerializationOArchive oa;
+    std::shared_lock lk(_rw_mutex);
+    oa.serialize(_states.size());
+    _states.forEach([&oa](const lk::Address& address, const AccountState& state) {
+        oa.serialize(address);
+        oa.serialize(state);
+    });
+    return std::move(oa).getBytes();
+}
+
+
+void StateManager::restoreSnapshot(const base::Bytes& snapshot)
+{
+    base::SerializationIArchive ia(snapshot);
+    AddressTable<AccountState> states;
+    auto states_size = ia.deserialize<std::size_t>();
+    for (std::size_t i = 0; i < states_size; ++i) {
+        auto address = ia.deserialize<lk::Address>();
+        states.insert(address, ia.deserialize<AccountState>());
+    }
+
+    std::unique_lock lk(_rw_mutex);
+    _states = std::move(states);
+    // code is loaded from the storage when it's first used
+    _code_store.clear();
+    _states.forEach([this](const lk::Address&, const AccountState& state) {
+        _code_store.addReference(state.code_hash);
+    });
+}
+
+
+void StateManager::setCodeStorage(ICodeStorage& storage)
+{
+    _code_store.setStorage(storage);
+}
+
+
+std::vector<std::pair<base::Sha256, ContractCode>> StateManager::takeNewContractsCode()
+{
+    return _code_store.takeNewCode();
+}
+
+
 AccountState& StateManager::_getAccount(const lk::Address& account_address)
 {
-    auto it = _states.find(account_address);
-    if (it == _states.end()) {
+    auto account = _states.find(account_address);
+    if (!account) {
         RAISE_ERROR(base::InvalidArgument, "cannot getAccount for non-existent account");
     }
-    else {
-        return it->second;
-    }
+    return *account;
 }
 
 
 const AccountState& StateManager::_getAccount(const lk::Address& account_address) const
 {
-    auto it = _states.find(account_address);
-    if (it == _states.end()) {
+    auto account = _states.find(account_address);
+    if (!account) {
         RAISE_ERROR(base::InvalidArgument, "cannot getAccount for non-existent account");
     }
-    else {
-        return it->second;
-    }
+    return *account;
 }
 
 
@@ -489,15 +585,14 @@ bool StateManager::_createClientAccount(const lk::Address& address)
         return false;
     }
 
-    AccountState state{ AccountType::CLIENT };
-    _states.insert({ address, state });
+    _states.insert(address, AccountState{ AccountType::CLIENT });
     return true;
 }
 
 lk::Balance StateManager::_getBalance(const lk::Address& account_address) const
 {
-    if (_hasAccount(account_address)) {
-        return _getAccount(account_address).balance;
+    if (auto account = _states.find(account_address)) {
+        return account->balance;
     }
     return {};
 }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "core/address_table.hpp"
 #include "core/block.hpp"
+#include "core/bytes_table.hpp"
+#include "core/code_store.hpp"
 #include "core/transaction.hpp"
 
+#include "base/serialization.hpp"
 #include "base/utility.hpp"
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <shared_mutex>
 
 namespace lk
@@ -24,37 +30,64 @@ struct AccountInfo
     lk::Address address;
     lk::Balance balance;
     std::uint64_t nonce;
-    std::vector<base::Sha256> transactions_hashes;
+    // hashes themselves are stored in the database and are requested page by page
+    std::uint64_t transactions_count;
 };
 
 
-struct StorageData
-{
-    StorageData() = default;
+/*
+ * Key or value of a contract storage: a word of the virtual machine. Both are kept inline,
+ * so reading and writing storage doesn't allocate.
+ */
+using StorageSlot = base::FixedBytes<32>;
+using ContractStorage = BytesTable<StorageSlot, StorageSlot>;
+
 
-    base::Bytes data;
-    bool was_modified{ false };
+struct ContractData
+{
+    ContractStorage storage;
 };
 
 
+/*
+ * Fields needed to check and apply transfers lie in the state itself, while storage is kept out of line:
+ * a table of states stays compact and most accounts, having no storage, don't allocate it at all.
+ * Code isn't kept in the state either, only its hash, by which the code is taken from the code store.
+ */
 struct AccountState
 {
     AccountType type;
     std::uint64_t nonce;
     lk::Balance balance;
-    base::Sha256 code_hash;
-    std::vector<base::Sha256> transactions;
-    std::map<base::Sha256, StorageData> storage;
-    base::Bytes runtime_code;
+    base::Sha256 code_hash; // of the runtime code, null if there is no code
     //============================
     explicit AccountState(AccountType initial_type);
+    AccountState(const AccountState& other);
+    AccountState(AccountState&& other) = default;
+    AccountState& operator=(const AccountState& other);
+    AccountState& operator=(AccountState&& other) = default;
     ~AccountState() = default;
+    //============================
+    const ContractData& getContractData() const; // empty if the account has no storage
+    ContractData& getContractData();             // allocated on the first call
+    //============================
+    static AccountState deserialize(base::SerializationIArchive& ia);
+    void serialize(base::SerializationOArchive& oa) const;
+    //============================
+  private:
+    std::unique_ptr<ContractData> _contract_data;
 };
 
 
 class StateManager;
 
 
+/*
+ * Changes of accounts made by a transaction over the state of the manager. Only changed fields are recorded, the
+ * rest is read from the manager, so touching an account doesn't copy its storage and applying the commit costs as
+ * much as the changes themselves. Balances are kept as deltas: the manager can change them in between, as fees are
+ * paid aside from the commit.
+ */
 class Commit
 {
     friend StateManager;
@@ -74,29 +107,40 @@ class Commit
     //================
     bool tryTransferMoney(const lk::Address& from, const lk::Address& to, const lk::Balance& amount);
     //================
-    bool checkStorageValue(const lk::Address& contract_address, const base::Sha256& key) const;
-    const StorageData& getStorageValue(const lk::Address& contract_address, const base::Sha256& key) const;
-    void setStorageValue(const lk::Address& contract_address, const base::Sha256& key, base::Bytes value);
+    std::optional<StorageSlot> findStorageValue(const lk::Address& contract_address, const StorageSlot& key) const;
+    StorageSlot getStorageValue(const lk::Address& contract_address, const StorageSlot& key) const; // zero if not set
+    void setStorageValue(const lk::Address& contract_address, const StorageSlot& key, const StorageSlot& value);
     lk::Balance getBalance(const lk::Address& account_address) const;
     std::size_t getCodeSize(const lk::Address& account_address) const;
     const base::Sha256& getCodeHash(const lk::Address& account_address) const;
-    const base::Bytes& getRuntimeCode(const lk::Address& account_address) const;
-    void setRuntimeCode(const lk::Address& contract_address, const base::Bytes& code);
+    ContractCode getRuntimeCode(const lk::Address& account_address) const;
+    void setRuntimeCode(const lk::Address& contract_address, base::Bytes code);
 
   private:
+    struct AccountChanges
+    {
+        std::unique_ptr<AccountState> created; // set if the commit creates the account, its initial state then
+        lk::Balance credit;
+        lk::Balance debit;
+        ContractStorage storage;   // only changed values
+        ContractCode runtime_code; // set if the code is replaced
+        base::Sha256 runtime_code_hash{ base::Sha256::null() };
+    };
+
     StateManager& _state_manager;
-    std::map<lk::Address, AccountState> _changed_states;
+    AddressTable<AccountChanges> _changes;
     std::set<lk::Address> _deleted_accounts;
     mutable std::shared_mutex _rw_mutex;
 
-    AccountState& _getAccount(const lk::Address& account_address);
-    const AccountState& _getAccount(const lk::Address& account_address) const;
-    const AccountState& _getAccountAnywhere(const lk::Address& account_address) const;
-    bool _hasAccountThis(const lk::Address& address) const;
-    bool _hasAccountRoot(const lk::Address& address) const;
-    bool _hasAccountAnywhere(const lk::Address& address) const;
-    bool _copyLocalIfNotExists(const lk::Address& address);
+    const AccountState* _findBaseAccount(const lk::Address& address) const; // created or taken from the manager
+    const AccountState& _getBaseAccount(const lk::Address& address) const;
+    const AccountState& _getContractBaseAccount(const lk::Address& address) const;
+    bool _hasAccount(const lk::Address& address) const;
+    lk::Balance _getBalance(const lk::Address& address) const;
+    const StorageSlot* _findStorageValue(const lk::Address& address, const StorageSlot& key) const;
+    AccountChanges& _getChanges(const lk::Address& address);
     bool _createClientAccount(const lk::Address& address);
+    bool _tryTransferMoney(const lk::Address& from, const lk::Address& to, const lk::Balance& amount);
 };
 
 
@@ -120,17 +164,39 @@ class StateManager
     Commit createCommit();
     void applyCommit(Commit&& commit);
     //================
-    void addTxHash(const lk::Address& address, const base::Sha256& tx_hash);
+    /*
+     * Counts a transaction sent from the address and returns its sequence number in the account history.
+     */
+    std::uint64_t registerTransaction(const lk::Address& address);
     void applyBlockEmission(const lk::Address& address, const lk::Balance& value);
     bool payFee(const lk::Address& from, const lk::Address& to, const lk::Balance& value);
     //================
     bool hasAccount(const lk::Address& address) const;
     AccountInfo getAccountInfo(const lk::Address& account_address) const;
     lk::Balance getBalance(const lk::Address& account_address) const;
+    //================
+    /*
+     * Serializes a consistent copy of all accounts states. The snapshot is later used
+     * to restore the manager without re-executing transactions of the whole chain.
+     */
+    base::Bytes takeSnapshot() const;
+    void restoreSnapshot(const base::Bytes& snapshot);
+    //================
+    /*
+     * Contracts code is read from the storage after a snapshot is restored, as snapshots hold only code hashes.
+     * Without a storage all code is kept in memory.
+     */
+    void setCodeStorage(ICodeStorage& storage);
+
+    /*
+     * Returns code deployed since the previous call. The caller stores it together with the block deploying it.
+     */
+    std::vector<std::pair<base::Sha256, ContractCode>> takeNewContractsCode();
 
   private:
     //================
-    std::map<lk::Address, AccountState> _states;
+    AddressTable<AccountState> _states;
+    CodeStore _code_store;
     mutable std::shared_mutex _rw_mutex;
     //================
     base::Observable<lk::Address> _event_account_update;
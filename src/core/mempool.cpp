@@ -0,0 +1,196 @@
+#include "mempool.hpp"
+
+#include "base/serialization.hpp"
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace lk
+{
+
+bool Mempool::FeeRateRank::operator<(const FeeRateRank& other) const noexcept
+{
+    // fee / bytes_size < other.fee / other.bytes_size without a division
+    using boost::multiprecision::uint128_t;
+    const auto rate = uint128_t{ fee } * other.bytes_size;
+    const auto other_rate = uint128_t{ other.fee } * bytes_size;
+    if (rate != other_rate) {
+        return rate < other_rate;
+    }
+    return arrival > other.arrival;
+}
+
+
+Mempool::Mempool(std::size_t max_block_transactions_number, const Limits& limits)
+  : _block_template{ max_block_transactions_number }
+  , _limits{ limits }
+{}
+
+
+Mempool::AdditionResult Mempool::add(const Transaction& tx,
+                                     const base::Time& now,
+                                     std::vector<Transaction>& evicted)
+{
+    if (contains(tx.hashOfTransaction())) {
+        return AdditionResult::ALREADY_PENDING;
+    }
+    if (isExpired(tx, now)) {
+        return AdditionResult::EXPIRED;
+    }
+
+    const Entry new_entry{ tx, _next_arrival, base::toBytes(tx).size() };
+    const auto new_rank = getFeeRateRank(new_entry);
+
+    // find out how many of the worst transactions must go, before anything is evicted
+    auto evicted_end = _by_fee_rate.begin();
+    std::size_t transactions_number = _transactions.size() + 1;
+    std::size_t bytes_size = _bytes_size + new_entry.bytes_size;
+    while (transactions_number > _limits.max_transactions || bytes_size > _limits.max_bytes) {
+        if (evicted_end == _by_fee_rate.end() || !(evicted_end->first < new_rank)) {
+            return AdditionResult::MEMPOOL_FULL;
+        }
+        --transactions_number;
+        bytes_size -= evicted_end->first.bytes_size;
+        ++evicted_end;
+    }
+
+    while (_by_fee_rate.begin() != evicted_end) {
+        const auto* worst = _by_fee_rate.begin()->second;
+        evicted.push_back(*worst);
+        remove(worst->hashOfTransaction());
+    }
+
+    ++_next_arrival;
+    auto it = _transactions.emplace(tx.hashOfTransaction(), new_entry).first;
+    const Entry& entry = it->second;
+    const Transaction& stored_tx = entry.tx;
+
+    auto& sender_queue = _senders[stored_tx.getFrom()];
+    sender_queue.transactions.emplace(entry.arrival, &stored_tx);
+    sender_queue.pending_spend += stored_tx.getAmount() + stored_tx.getFee();
+    _block_template.add(stored_tx);
+    _by_fee_rate.emplace(new_rank, &stored_tx);
+    _by_timestamp.emplace(std::make_pair(stored_tx.getTimestamp().getSeconds(), entry.arrival), &stored_tx);
+    _bytes_size += entry.bytes_size;
+    return AdditionResult::ADDED;
+}
+
+
+void Mempool::remove(const base::Sha256& tx_hash)
+{
+    auto it = _transactions.find(tx_hash);
+    if (it == _transactions.end()) {
+        return;
+    }
+    const auto& entry = it->second;
+    const auto& tx = entry.tx;
+
+    _block_template.remove(tx);
+    if (auto sender_it = _senders.find(tx.getFrom()); sender_it != _senders.end()) {
+        auto& sender_queue = sender_it->second;
+        sender_queue.transactions.erase(entry.arrival);
+        sender_queue.pending_spend -= tx.getAmount() + tx.getFee();
+        if (sender_queue.transactions.empty()) {
+            _senders.erase(sender_it);
+        }
+    }
+    _by_fee_rate.erase(getFeeRateRank(entry));
+    _by_timestamp.erase(std::make_pair(tx.getTimestamp().getSeconds(), entry.arrival));
+    _bytes_size -= entry.bytes_size;
+    _transactions.erase(it);
+}
+
+
+void Mempool::remove(const TransactionsSet& txs)
+{
+    for (const auto& tx : txs) {
+        remove(tx.hashOfTransaction());
+    }
+}
+
+
+std::vector<Transaction> Mempool::removeExpired(const base::Time& now)
+{
+    std::vector<Transaction> ret;
+    while (!_by_timestamp.empty() && isExpired(*_by_timestamp.begin()->second, now)) {
+        const auto* oldest = _by_timestamp.begin()->second;
+        ret.push_back(*oldest);
+        remove(oldest->hashOfTransaction());
+    }
+    return ret;
+}
+
+
+bool Mempool::contains(const base::Sha256& tx_hash) const
+{
+    return _transactions.find(tx_hash) != _transactions.end();
+}
+
+
+std::optional<Transaction> Mempool::find(const base::Sha256& tx_hash) const
+{
+    if (auto it = _transactions.find(tx_hash); it != _transactions.end()) {
+        return it->second.tx;
+    }
+    return std::nullopt;
+}
+
+
+std::vector<const Transaction*> Mempool::getSenderTransactions(const Address& sender) const
+{
+    std::vector<const Transaction*> ret;
+    if (auto it = _senders.find(sender); it != _senders.end()) {
+        ret.reserve(it->second.transactions.size());
+        for (const auto& [arrival, tx] : it->second.transactions) {
+            ret.push_back(tx);
+        }
+    }
+    return ret;
+}
+
+
+Balance Mempool::getPendingSpend(const Address& sender) const
+{
+    if (auto it = _senders.find(sender); it != _senders.end()) {
+        return it->second.pending_spend;
+    }
+    return Balance{ 0 };
+}
+
+
+TransactionsSet Mempool::getBlockTransactions() const
+{
+    return _block_template.getTransactions();
+}
+
+
+const Balance& Mempool::getBlockFeeValue() const noexcept
+{
+    return _block_template.getFeeValue();
+}
+
+
+std::size_t Mempool::size() const noexcept
+{
+    return _transactions.size();
+}
+
+
+std::size_t Mempool::getBytesSize() const noexcept
+{
+    return _bytes_size;
+}
+
+
+Mempool::FeeRateRank Mempool::getFeeRateRank(const Entry& entry) noexcept
+{
+    return { entry.tx.getFee(), entry.bytes_size, entry.arrival };
+}
+
+
+bool Mempool::isExpired(const Transaction& tx, const base::Time& now) const
+{
+    const auto lifetime = static_cast<std::uint64_t>(_limits.transaction_lifetime.count());
+    return std::uint64_t{ tx.getTimestamp().getSeconds() } + lifetime < now.getSeconds();
+}
+
+} // namespace lk
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/address.hpp"
+#include "core/block_template.hpp"
+#include "core/transaction.hpp"
+#include "core/transactions_set.hpp"
+#include "core/types.hpp"
+
+#include "base/time.hpp"
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace lk
+{
+
+/*
+ * Pending transactions, indexed by hash, by sender (in the order of arrival) and by fee: the best by fee ones
+ * that fit into a block are kept in a BlockTemplate. Addition, lookup and removal cost a hash lookup plus
+ * logarithmic index updates, so neither depends linearly on the number of pending transactions.
+ * Every sender's pending spend is kept up to date as well, so an admission check is a single lookup.
+ *
+ * The mempool is bounded by the number of transactions and by their serialized size. When it is full, the
+ * transactions with the lowest fee per byte are evicted, and transactions older than the lifetime are expired.
+ */
+class Mempool
+{
+  public:
+    //=================
+    struct Limits
+    {
+        std::size_t max_transactions;
+        std::size_t max_bytes;
+        std::chrono::seconds transaction_lifetime; // counted from the transaction timestamp
+    };
+
+    enum class AdditionResult
+    {
+        ADDED,
+        ALREADY_PENDING,
+        MEMPOOL_FULL, // every transaction that would have to be evicted pays at least as much per byte
+        EXPIRED
+    };
+    //=================
+    Mempool(std::size_t max_block_transactions_number, const Limits& limits);
+    Mempool(const Mempool&) = delete;
+    Mempool& operator=(const Mempool&) = delete;
+    ~Mempool() = default;
+    //=================
+    // transactions evicted to make room for the added one are appended to evicted
+    AdditionResult add(const Transaction& tx, const base::Time& now, std::vector<Transaction>& evicted);
+    void remove(const base::Sha256& tx_hash);
+    void remove(const TransactionsSet& txs);
+    std::vector<Transaction> removeExpired(const base::Time& now);
+    //=================
+    bool contains(const base::Sha256& tx_hash) const;
+    std::optional<Transaction> find(const base::Sha256& tx_hash) const;
+    std::vector<const Transaction*> getSenderTransactions(const Address& sender) const; // in the order of arrival
+    Balance getPendingSpend(const Address& sender) const; // sum of amounts and fees of the sender's transactions
+    //=================
+    TransactionsSet getBlockTransactions() const; // the best by fee that fit into a block, in the order of arrival
+    const Balance& getBlockFeeValue() const noexcept;
+    //=================
+    std::size_t size() const noexcept;
+    std::size_t getBytesSize() const noexcept;
+    //=================
+  private:
+    //=================
+    struct Entry
+    {
+        Transaction tx;
+        std::uint64_t arrival;
+        std::size_t bytes_size;
+    };
+
+    struct FeeRateRank
+    {
+        Fee fee;
+        std::size_t bytes_size;
+        std::uint64_t arrival;
+        //=================
+        bool operator<(const FeeRateRank& other) const noexcept; // lower fee per byte first, then the newer first
+    };
+
+    struct SenderQueue
+    {
+        std::map<std::uint64_t, const Transaction*> transactions; // by arrival
+        Balance pending_spend{ 0 };
+    };
+    //=================
+    std::uint64_t _next_arrival{ 0 };
+    // node-based, so pointers to transactions stay valid while they are pending
+    std::unordered_map<base::Sha256, Entry> _transactions;
+    std::unordered_map<Address, SenderQueue> _senders;
+    BlockTemplate _block_template;
+    std::map<FeeRateRank, const Transaction*> _by_fee_rate;
+    std::map<std::pair<std::uint_least32_t, std::uint64_t>, const Transaction*> _by_timestamp; // with arrival
+    //=================
+    const Limits _limits;
+    std::size_t _bytes_size{ 0 };
+    //=================
+    static FeeRateRank getFeeRateRank(const Entry& entry) noexcept;
+    bool isExpired(const Transaction& tx, const base::Time& now) const;
+};
+
+} // namespace lk
@@ -300,7 +300,7 @@ void Peer::Synchronizer::handleReceivedTopBlockHash(const base::Sha256& peers_to
         return; // nothing changes, because top blocks are equal
     }
     else {
-        if (_peer._core.findBlock(peers_top_block)) {
+        if (_peer._core.findBlockHeader(peers_top_block)) {
             _peer.setState(lk::Peer::State::SYNCHRONISED);
             // do nothing, because we are ahead of this peer and we don't need to sync: this node might sync
             return;
@@ -344,7 +344,7 @@ bool Peer::Synchronizer::handleReceivedBlock(const base::Sha256& hash, const Imm
             }
             return true;
         }
-        else if (_peer._core.findBlock(next)) {
+        else if (_peer._core.findBlockHeader(next)) {
             LOG_DEBUG << "Peer " << &_peer << " applying all " << _sync_blocks.size() << " sync blocks";
             for (auto it = _sync_blocks.crbegin(); it != _sync_blocks.crend(); ++it) {
                 if (_peer._core.tryAddBlock(*it) != Blockchain::AdditionResult ::ADDED) {
@@ -591,7 +591,7 @@ void Peer::handle(lk::msg::GetBlock&& msg)
 void Peer::handle(lk::msg::Block&& msg)
 {
     PEER_LOG << "handling received " << msg.block_hash << " block";
-    if (msg.block_hash != base::Sha256::compute(base::toBytes(msg.block))) {
+    if (msg.block_hash != msg.block.getHash()) {
         PEER_LOG << "invalid message";
         _rating.invalidMessage();
         return;
@@ -610,7 +610,7 @@ void Peer::handle(lk::msg::BlockNotFound&& msg)
 void Peer::handle(lk::msg::NewBlock&& msg)
 {
     PEER_LOG << "handling received " << msg.block_hash << " block";
-    if (msg.block_hash != base::Sha256::compute(base::toBytes(msg.block))) { // TODO: use checksum
+    if (msg.block_hash != msg.block.getHash()) { // TODO: use checksum
         PEER_LOG << "invalid message";
         _rating.invalidMessage();
         return;
@@ -7,7 +7,10 @@ namespace lk
 
 RatingManager::RatingManager(const base::Directory& db_path)
   : _db{ db_path }
-{}
+{
+    // ratings are updated from peer threads concurrently, so their synced writes are merged
+    _db.enableGroupCommit();
+}
 
 
 Rating RatingManager::get(const net::Endpoint& ep)
@@ -70,7 +73,9 @@ Rating::Value Rating::getValue()
 
 void Rating::dbUpdate()
 {
-    _db.put(_serialized_ep, base::toBytes(_data));
+    base::Database::WriteBatch batch;
+    batch.put(_serialized_ep, base::toBytes(_data));
+    _db.write(std::move(batch));
 }
 
 
@@ -0,0 +1,127 @@
+#include "signature_verifier.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <future>
+#include <memory>
+
+namespace lk
+{
+
+SignatureVerifier::SignatureVerifier(std::size_t threads_number, std::size_t verified_cache_size)
+  : _threads_number{ std::max<std::size_t>(threads_number, 1) }
+  , _pool{ _threads_number }
+  , _verified{ verified_cache_size }
+{}
+
+
+SignatureVerifier::~SignatureVerifier()
+{
+    _pool.join();
+}
+
+
+bool SignatureVerifier::verify(const Transaction& tx)
+{
+    if (isVerified(tx)) {
+        return true;
+    }
+    if (!tx.checkSign()) {
+        return false;
+    }
+    _verified.put(tx.hashOfTransaction(), tx.getSign());
+    return true;
+}
+
+
+bool SignatureVerifier::verifyAll(const TransactionsSet& txs)
+{
+    std::vector<const Transaction*> not_verified;
+    for (const auto& tx : txs) {
+        if (!isVerified(tx)) {
+            not_verified.push_back(&tx);
+        }
+    }
+
+    const auto is_sign_valid = verifyNotCached(not_verified);
+    return std::all_of(is_sign_valid.begin(), is_sign_valid.end(), [](bool is_valid) { return is_valid; });
+}
+
+
+std::vector<bool> SignatureVerifier::verifyEach(const std::vector<Transaction>& txs)
+{
+    std::vector<bool> ret(txs.size(), true);
+    std::vector<std::size_t> not_verified_indexes;
+    std::vector<const Transaction*> not_verified;
+    for (std::size_t i = 0; i < txs.size(); ++i) {
+        if (!isVerified(txs[i])) {
+            not_verified_indexes.push_back(i);
+            not_verified.push_back(&txs[i]);
+        }
+    }
+
+    const auto is_sign_valid = verifyNotCached(not_verified);
+    for (std::size_t i = 0; i < not_verified.size(); ++i) {
+        ret[not_verified_indexes[i]] = is_sign_valid[i];
+    }
+    return ret;
+}
+
+
+bool SignatureVerifier::isVerified(const Transaction& tx)
+{
+    // a copy with the same content and another signature must be checked on its own
+    const auto verified_sign = _verified.find(tx.hashOfTransaction());
+    return verified_sign && *verified_sign == tx.getSign();
+}
+
+
+std::vector<bool> SignatureVerifier::verifyNotCached(const std::vector<const Transaction*>& txs)
+{
+    const auto tasks_number = std::min(_threads_number, txs.size() / MIN_SIGNATURES_PER_TASK);
+    if (tasks_number <= 1) {
+        return verifyRange(txs, 0, txs.size());
+    }
+
+    // the calling thread takes the first range itself, the rest go to the pool
+    const auto range_size = (txs.size() + tasks_number - 1) / tasks_number;
+    std::vector<std::future<std::vector<bool>>> results;
+    for (std::size_t begin = range_size; begin < txs.size(); begin += range_size) {
+        const auto end = std::min(begin + range_size, txs.size());
+        // asio takes a posted packaged_task for a completion token, so it is wrapped
+        auto task = std::make_shared<std::packaged_task<std::vector<bool>()>>(
+          [this, &txs, begin, end] { return verifyRange(txs, begin, end); });
+        results.push_back(task->get_future());
+        boost::asio::post(_pool, [task] { (*task)(); });
+    }
+
+    auto ret = verifyRange(txs, 0, range_size);
+    // every task must be finished before txs can go out of scope
+    for (auto& result : results) {
+        result.wait();
+    }
+    ret.reserve(txs.size());
+    for (auto& result : results) {
+        const auto range_result = result.get();
+        ret.insert(ret.end(), range_result.begin(), range_result.end());
+    }
+    return ret;
+}
+
+
+std::vector<bool> SignatureVerifier::verifyRange(const std::vector<const Transaction*>& txs,
+                                                 std::size_t begin,
+                                                 std::size_t end)
+{
+    const std::vector<const Transaction*> range(txs.begin() + begin, txs.begin() + end);
+    auto is_sign_valid = Transaction::checkSigns(range);
+    for (std::size_t i = 0; i < range.size(); ++i) {
+        if (is_sign_valid[i]) {
+            _verified.put(range[i]->hashOfTransaction(), range[i]->getSign());
+        }
+    }
+    return is_sign_valid;
+}
+
+} // namespace lk
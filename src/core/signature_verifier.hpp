@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/transaction.hpp"
+#include "core/transactions_set.hpp"
+
+#include "base/hash.hpp"
+#include "base/utility.hpp"
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <vector>
+
+namespace lk
+{
+
+/*
+ * Checks transaction signatures on a pool of threads, so a received block can be checked before the blockchain
+ * lock is taken. Valid signatures are remembered by the transaction hash: a transaction checked when it got into
+ * the pending set is not checked again when it comes in a block. The hash doesn't cover the signature, so a cached
+ * entry counts only for the very signature that was checked.
+ */
+class SignatureVerifier
+{
+  public:
+    //=================
+    SignatureVerifier(std::size_t threads_number, std::size_t verified_cache_size);
+    SignatureVerifier(const SignatureVerifier&) = delete;
+    SignatureVerifier& operator=(const SignatureVerifier&) = delete;
+    ~SignatureVerifier();
+    //=================
+    // all are thread-safe
+    bool verify(const Transaction& tx);
+    bool verifyAll(const TransactionsSet& txs);                        // true if every signature is valid
+    std::vector<bool> verifyEach(const std::vector<Transaction>& txs); // validity of every signature in order
+    //=================
+  private:
+    //=================
+    // smaller sets are not split between threads, since a task switch costs more than a few checks
+    static constexpr std::size_t MIN_SIGNATURES_PER_TASK = 8;
+    //=================
+    const std::size_t _threads_number;
+    boost::asio::thread_pool _pool;
+    base::LruCache<base::Sha256, Sign> _verified; // only valid signatures are stored
+    //=================
+    bool isVerified(const Transaction& tx);
+    std::vector<bool> verifyNotCached(const std::vector<const Transaction*>& txs);
+    std::vector<bool> verifyRange(const std::vector<const Transaction*>& txs, std::size_t begin, std::size_t end);
+    //=================
+};
+
+} // namespace lk
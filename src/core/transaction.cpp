@@ -2,6 +2,138 @@
 
 #include "base/error.hpp"
 
+#include <array>
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+
+/*
+ * The functions below feed the hash with the same text as the transaction hash specification
+ * describes (see public_interface.md), but encode it piece by piece in stack buffers.
+ */
+
+template<std::size_t S>
+void updateWithBase58(base::Sha256Builder& builder, const base::FixedBytes<S>& bytes)
+{
+    static constexpr char BASE58_ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    static constexpr std::size_t MAX_DIGITS = S * 138 / 100 + 1; // log(256) / log(58)
+
+    std::size_t current_pos = 0;
+    while (current_pos != S && bytes[current_pos] == 0) {
+        current_pos++;
+    }
+    const std::size_t zeroes_count = current_pos;
+
+    std::array<base::Byte, MAX_DIGITS> b58{};
+    std::size_t length = 0;
+    for (; current_pos != S; ++current_pos) {
+        auto carry = static_cast<std::size_t>(bytes[current_pos]);
+        std::size_t i = 0;
+        for (auto it = b58.rbegin(); (carry != 0 || i < length) && it != b58.rend(); ++it, ++i) {
+            carry += 256 * (*it);
+            *it = static_cast<base::Byte>(carry % 58);
+            carry /= 58;
+        }
+        length = i;
+    }
+    auto it = b58.begin() + (MAX_DIGITS - length);
+    while (it != b58.end() && *it == 0) {
+        ++it;
+    }
+
+    std::array<char, S + MAX_DIGITS> encoded;
+    std::size_t encoded_length = 0;
+    for (; encoded_length < zeroes_count; ++encoded_length) {
+        encoded[encoded_length] = '1';
+    }
+    for (; it != b58.end(); ++it) {
+        encoded[encoded_length++] = BASE58_ALPHABET[*it];
+    }
+    builder.update(std::string_view(encoded.data(), encoded_length));
+}
+
+
+template<typename T>
+void updateWithDecimal(base::Sha256Builder& builder, T value)
+{
+    std::array<char, 20> encoded; // enough for any 64-bit number
+    auto result = std::to_chars(encoded.data(), encoded.data() + encoded.size(), value);
+    builder.update(std::string_view(encoded.data(), static_cast<std::size_t>(result.ptr - encoded.data())));
+}
+
+
+void updateWithDecimal(base::Sha256Builder& builder, lk::Balance value)
+{
+    // the number is split into parts of 19 decimal digits, the biggest power of 10 that fits into 64 bits
+    static constexpr std::uint64_t PART_BASE = 10'000'000'000'000'000'000ULL;
+    static constexpr std::size_t PART_DIGITS = 19;
+    static constexpr std::size_t MAX_PARTS = 5; // 2^256 < 10^95
+
+    std::array<std::uint64_t, MAX_PARTS> parts;
+    std::size_t parts_count = 0;
+    do {
+        parts[parts_count++] = static_cast<std::uint64_t>(value % PART_BASE);
+        value /= PART_BASE;
+    } while (value != 0);
+
+    updateWithDecimal(builder, parts[parts_count - 1]);
+
+    std::array<char, PART_DIGITS> encoded;
+    for (std::size_t part_index = parts_count - 1; part_index > 0; --part_index) {
+        auto part = parts[part_index - 1];
+        for (auto it = encoded.rbegin(); it != encoded.rend(); ++it) {
+            *it = static_cast<char>('0' + part % 10);
+            part /= 10;
+        }
+        builder.update(std::string_view(encoded.data(), encoded.size()));
+    }
+}
+
+
+void updateWithBase64(base::Sha256Builder& builder, const base::Bytes& data)
+{
+    static constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::array<char, 256> encoded; // size must be a multiple of 4
+    std::size_t encoded_length = 0;
+
+    const auto flush = [&builder, &encoded, &encoded_length] {
+        builder.update(std::string_view(encoded.data(), encoded_length));
+        encoded_length = 0;
+    };
+
+    std::size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        std::uint32_t group = (std::uint32_t{ data[i] } << 16) | (std::uint32_t{ data[i + 1] } << 8) | data[i + 2];
+        encoded[encoded_length++] = BASE64_ALPHABET[(group >> 18) & 0x3F];
+        encoded[encoded_length++] = BASE64_ALPHABET[(group >> 12) & 0x3F];
+        encoded[encoded_length++] = BASE64_ALPHABET[(group >> 6) & 0x3F];
+        encoded[encoded_length++] = BASE64_ALPHABET[group & 0x3F];
+        if (encoded_length == encoded.size()) {
+            flush();
+        }
+    }
+
+    if (auto rest = data.size() - i; rest != 0) {
+        std::uint32_t group = std::uint32_t{ data[i] } << 16;
+        if (rest == 2) {
+            group |= std::uint32_t{ data[i + 1] } << 8;
+        }
+        encoded[encoded_length++] = BASE64_ALPHABET[(group >> 18) & 0x3F];
+        encoded[encoded_length++] = BASE64_ALPHABET[(group >> 12) & 0x3F];
+        encoded[encoded_length++] = rest == 2 ? BASE64_ALPHABET[(group >> 6) & 0x3F] : '=';
+        encoded[encoded_length++] = '=';
+    }
+
+    if (encoded_length != 0) {
+        flush();
+    }
+}
+
+} // namespace
+
 
 namespace lk
 {
@@ -20,6 +152,7 @@ Transaction::Transaction(Address from,
   , _timestamp{ timestamp }
   , _data{ std::move(data) }
   , _sign{ std::move(sign) }
+  , _hash{ computeHash() }
 {
     if ((_amount == 0) && (_fee == 0)) {
         RAISE_ERROR(base::LogicError, "Transaction cannot contain amount equal to 0");
@@ -89,6 +222,28 @@ bool Transaction::checkSign() const
 }
 
 
+std::vector<bool> Transaction::checkSigns(const std::vector<const Transaction*>& txs)
+{
+    std::vector<base::Secp256PrivateKey::Signature> signatures;
+    std::vector<base::Bytes> signed_bytes;
+    signatures.reserve(txs.size());
+    signed_bytes.reserve(txs.size());
+    for (const auto* tx : txs) {
+        signatures.push_back(tx->_sign);
+        signed_bytes.push_back(tx->hashOfTransaction().getBytes().toBytes());
+    }
+
+    const auto public_keys = base::Secp256PrivateKey::decodeSignaturesToPublicKeys(signatures, signed_bytes);
+    std::vector<bool> ret(txs.size(), false);
+    for (std::size_t i = 0; i < txs.size(); ++i) {
+        if (!txs[i]->_sign.toBytes().isEmpty() && public_keys[i]) {
+            ret[i] = txs[i]->_from == lk::Address(*public_keys[i]);
+        }
+    }
+    return ret;
+}
+
+
 const Sign& Transaction::getSign() const noexcept
 {
     return _sign;
@@ -108,19 +263,23 @@ bool Transaction::operator!=(const Transaction& other) const
 }
 
 
-base::Sha256 Transaction::hashOfTransaction() const
+const base::Sha256& Transaction::hashOfTransaction() const noexcept
 {
-    // see public_interface.md
-    auto from_address_str = base::base58Encode(_from.getBytes());
-    auto to_address_str = base::base58Encode(_to.getBytes());
-    auto amount_str = _amount.str();
-    auto fee_str = std::to_string(_fee);
-    auto timestamp_str = std::to_string(_timestamp.getSeconds());
-    auto data_str = base::base64Encode(_data);
+    return _hash;
+}
 
-    auto concatenated_data = from_address_str + to_address_str + amount_str + fee_str + timestamp_str + data_str;
 
-    return base::Sha256::compute(base::Bytes(concatenated_data));
+base::Sha256 Transaction::computeHash() const
+{
+    // see public_interface.md
+    base::Sha256Builder builder;
+    updateWithBase58(builder, _from.getBytes());
+    updateWithBase58(builder, _to.getBytes());
+    updateWithDecimal(builder, _amount);
+    updateWithDecimal(builder, _fee);
+    updateWithDecimal(builder, _timestamp.getSeconds());
+    updateWithBase64(builder, _data);
+    return builder.finalize();
 }
 
 
@@ -298,4 +457,23 @@ Fee TransactionStatus::getFeeLeft() const noexcept
     return _fee_left;
 }
 
+
+void TransactionStatus::serialize(base::SerializationOArchive& oa) const
+{
+    oa.serialize(_status);
+    oa.serialize(_action);
+    oa.serialize(_message);
+    oa.serialize(_fee_left);
+}
+
+
+TransactionStatus TransactionStatus::deserialize(base::SerializationIArchive& ia)
+{
+    auto status = ia.deserialize<StatusCode>();
+    auto action = ia.deserialize<ActionType>();
+    auto message = ia.deserialize<std::string>();
+    auto fee_left = ia.deserialize<Fee>();
+    return TransactionStatus{ status, action, fee_left, message };
+}
+
 } // namespace lk
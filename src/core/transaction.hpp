@@ -7,6 +7,8 @@
 #include "base/serialization.hpp"
 #include "base/time.hpp"
 
+#include <vector>
+
 namespace lk
 {
 
@@ -40,12 +42,15 @@ class Transaction
     //=================
     void sign(const base::Secp256PrivateKey& key);
     bool checkSign() const;
+    // same as checkSign for every transaction, but public keys are recovered in one batch
+    static std::vector<bool> checkSigns(const std::vector<const Transaction*>& txs);
     const lk::Sign& getSign() const noexcept;
     //=================
     bool operator==(const Transaction& other) const;
     bool operator!=(const Transaction& other) const;
     //=================
-    base::Sha256 hashOfTransaction() const;
+    // computed once on construction, so copies and deserialized transactions carry it as well
+    const base::Sha256& hashOfTransaction() const noexcept;
     //=================
     static Transaction deserialize(base::SerializationIArchive& ia);
     void serialize(base::SerializationOArchive& oa) const;
@@ -60,6 +65,10 @@ class Transaction
     base::Bytes _data;
     Sign _sign;
     //=================
+    base::Sha256 _hash;
+
+    base::Sha256 computeHash() const;
+    //=================
 };
 
 
@@ -139,6 +148,9 @@ class TransactionStatus
 
     std::uint64_t getFeeLeft() const noexcept;
 
+    void serialize(base::SerializationOArchive& oa) const;
+    static TransactionStatus deserialize(base::SerializationIArchive& ia);
+
   private:
     StatusCode _status;
     ActionType _action;
@@ -139,8 +139,7 @@ std::map<Address, Balance> calcCost(const TransactionsSet& txs)
 {
     std::map<Address, Balance> result;
     for (const auto& tx : txs) {
-        auto tx_cost = tx.getAmount() + tx.getFee();
-        result.insert({ tx.getFrom(), tx_cost });
+        result[tx.getFrom()] += tx.getAmount() + tx.getFee();
     }
     return result;
 }
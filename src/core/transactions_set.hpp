@@ -44,6 +44,7 @@ class TransactionsSet
 };
 
 
+// sum of amounts and fees of all transactions of every sender
 std::map<Address, Balance> calcCost(const TransactionsSet& txs);
 
 } // namespace lk
\ No newline at end of file
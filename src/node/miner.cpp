@@ -1,34 +1,220 @@
 #include "miner.hpp"
 
+#include "base/error.hpp"
 #include "base/log.hpp"
 
-#include <random>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <utility>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace
 {
 
-std::size_t calcThreadsNum(base::json::Value config)
+std::size_t calcThreadsNum(const base::json::Value& config, const std::vector<unsigned>& cpus)
 {
     if (config.has_number_field("threads")) {
-        auto threads_value = config["threads"].as_number();
+        auto threads_value = config.at("threads").as_number();
         if (threads_value.is_uint64()) {
             return threads_value.to_uint64();
         }
     }
+    if (!cpus.empty()) {
+        return cpus.size();
+    }
     return std::thread::hardware_concurrency();
 }
 
+
+// parses the kernel cpulist format, e.g. "0-3,8,10-11"
+std::vector<unsigned> parseCpuList(const std::string& cpu_list)
+{
+    std::vector<unsigned> ret;
+    std::istringstream stream{ cpu_list };
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        const auto dash = range.find('-');
+        try {
+            const auto first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            const auto last =
+              dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            for (auto cpu = first; cpu <= last; ++cpu) {
+                ret.push_back(cpu);
+            }
+        }
+        catch (const std::logic_error&) {
+            RAISE_ERROR(base::ParsingError, std::string{ "invalid cpu list: " } + cpu_list);
+        }
+    }
+    return ret;
+}
+
+
+std::vector<unsigned> readNumaNodeCpus(std::uint64_t numa_node)
+{
+    const auto path = "/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist";
+    std::ifstream file{ path };
+    if (!file) {
+        RAISE_ERROR(base::InaccessibleFile, std::string{ "cannot read cpus of NUMA node: " } + path);
+    }
+    std::string cpu_list;
+    std::getline(file, cpu_list);
+    return parseCpuList(cpu_list);
+}
+
+
+std::vector<unsigned> calcCpus(const base::json::Value& config)
+{
+    if (!config.has_object_field("affinity")) {
+        return {};
+    }
+    const auto& affinity = config.at("affinity");
+
+    std::optional<std::vector<unsigned>> cores;
+    if (affinity.has_array_field("cores")) {
+        cores.emplace();
+        for (const auto& core : affinity.at("cores").as_array()) {
+            if (!core.is_number() || !core.as_number().is_uint32()) {
+                RAISE_ERROR(base::InvalidArgument, "miner \"affinity.cores\" must be a list of cpu numbers");
+            }
+            cores->push_back(core.as_number().to_uint32());
+        }
+    }
+
+    std::optional<std::vector<unsigned>> numa_cpus;
+    if (affinity.has_number_field("numa_node")) {
+        auto numa_node_value = affinity.at("numa_node").as_number();
+        if (!numa_node_value.is_uint64()) {
+            RAISE_ERROR(base::InvalidArgument, "miner \"affinity.numa_node\" must be a non-negative integer");
+        }
+        numa_cpus = readNumaNodeCpus(numa_node_value.to_uint64());
+    }
+
+    std::vector<unsigned> ret;
+    if (cores && numa_cpus) {
+        // only the listed cores that belong to the NUMA node
+        std::sort(numa_cpus->begin(), numa_cpus->end());
+        for (auto core : *cores) {
+            if (std::binary_search(numa_cpus->begin(), numa_cpus->end(), core)) {
+                ret.push_back(core);
+            }
+        }
+    }
+    else if (cores) {
+        ret = std::move(*cores);
+    }
+    else if (numa_cpus) {
+        ret = std::move(*numa_cpus);
+    }
+    else {
+        return {};
+    }
+
+    if (ret.empty()) {
+        RAISE_ERROR(base::InvalidArgument, "miner \"affinity\" leaves no cpus to run on");
+    }
+#if !defined(__linux__)
+    LOG_WARNING << "Miner thread affinity is supported only on Linux, the \"affinity\" option is ignored";
+    ret.clear();
+#endif
+    return ret;
+}
+
+
+impl::StripeExhaustedAction calcStripeExhaustedAction(const base::json::Value& config)
+{
+    if (!config.has_string_field("on_stripe_exhausted")) {
+        return impl::StripeExhaustedAction::ROLL_TIMESTAMP;
+    }
+    const auto& action = config.at("on_stripe_exhausted").as_string();
+    if (action == "roll_timestamp") {
+        return impl::StripeExhaustedAction::ROLL_TIMESTAMP;
+    }
+    else if (action == "wait") {
+        return impl::StripeExhaustedAction::WAIT_FOR_JOB;
+    }
+    RAISE_ERROR(base::InvalidArgument, "miner \"on_stripe_exhausted\" must be \"roll_timestamp\" or \"wait\"");
+}
+
+
+impl::MinerSettings readSettings(const base::json::Value& config)
+{
+    auto cpus = calcCpus(config);
+    const auto threads = calcThreadsNum(config, cpus);
+    return { threads, std::move(cpus), calcStripeExhaustedAction(config) };
+}
+
+
+void pinCurrentThread([[maybe_unused]] unsigned cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set); error != 0) {
+        LOG_WARNING << "Cannot pin miner thread to cpu " << cpu << ", error code " << error;
+    }
+#endif
+}
+
 } // namespace
 
 
 namespace impl
 {
 
-CommonState::CommonState(CommonData&& initial_state, MinerHandlerType handler)
+NonceStripe getNonceStripe(std::size_t worker_index, std::size_t workers_number) noexcept
+{
+    ASSERT(worker_index < workers_number);
+    const auto stripe_size = std::numeric_limits<lk::NonceInt>::max() / workers_number;
+    const lk::NonceInt first = stripe_size * worker_index;
+    if (worker_index + 1 == workers_number) {
+        return { first, std::numeric_limits<lk::NonceInt>::max() };
+    }
+    return { first, first + stripe_size - 1 };
+}
+
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) noexcept
+{
+    auto microseconds =
+      static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    std::size_t bucket = 0;
+    for (; microseconds > 0 && bucket + 1 < _counts.size(); microseconds >>= 1) {
+        ++bucket;
+    }
+    _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+LatencyHistogram::Counts LatencyHistogram::getCounts() const noexcept
+{
+    Counts ret;
+    for (std::size_t i = 0; i < ret.size(); ++i) {
+        ret[i] = _counts[i].load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+
+CommonState::CommonState(CommonData&& initial_state, MinerHandlerType handler, std::size_t workers_number)
   : _version{ 0 }
   , _common_data{ std::move(initial_state) }
   , _handler{ handler }
+  , _workers_number{ workers_number }
+  , _version_changed_at{ std::chrono::steady_clock::now() }
 {}
 
 
@@ -50,6 +236,7 @@ void CommonState::setCommonData(const CommonData& data)
 {
     std::unique_lock lk(_state_mutex);
     _version.fetch_add(1, std::memory_order_release);
+    onVersionChanged();
     _common_data = data;
     _state_changed_cv.notify_all();
 }
@@ -69,6 +256,8 @@ void CommonState::callHandlerAndDrop(Args&&... args)
         }
 
         _version.fetch_add(1, std::memory_order_release);
+        onVersionChanged();
+        _found_solutions.fetch_add(1, std::memory_order_relaxed);
         _common_data.task = Task::DROP_JOB;
         _common_data.block_to_mine.reset();
         _common_data.complexity.reset();
@@ -85,6 +274,30 @@ void CommonState::waitAndReadNewData(std::size_t& last_read_version, CommonData&
     _state_changed_cv.wait(lk, [this, last_read_version] { return getVersion() != last_read_version; });
     last_read_version = getVersion();
     data = _common_data;
+
+    // versions are changed under the unique lock, so the counter belongs to the version that was just read
+    if (_workers_left_to_pick_up.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _job_switch_latency.record(std::chrono::steady_clock::now() - _version_changed_at);
+    }
+}
+
+
+LatencyHistogram::Counts CommonState::getJobSwitchLatency() const noexcept
+{
+    return _job_switch_latency.getCounts();
+}
+
+
+std::uint64_t CommonState::getFoundSolutionsNumber() const noexcept
+{
+    return _found_solutions.load(std::memory_order_relaxed);
+}
+
+
+void CommonState::onVersionChanged()
+{
+    _version_changed_at = std::chrono::steady_clock::now();
+    _workers_left_to_pick_up.store(_workers_number, std::memory_order_release);
 }
 
 
@@ -92,14 +305,27 @@ class MinerWorker
 {
   public:
     //===================
-    MinerWorker(CommonState& common_state);
+    MinerWorker(CommonState& common_state,
+                NonceStripe stripe,
+                StripeExhaustedAction on_stripe_exhausted,
+                std::optional<unsigned> cpu);
     ~MinerWorker();
     //===================
+    MinerStatistics::Worker getStatistics() const;
+    //===================
   private:
     //===================
     std::thread _worker_thread;
     //===================
     CommonState& _common_state;
+    const NonceStripe _stripe;
+    const StripeExhaustedAction _on_stripe_exhausted;
+    const std::optional<unsigned> _cpu;
+    //===================
+    // written only by the worker thread
+    std::atomic<std::uint64_t> _hashes{ 0 };
+    std::atomic<std::int64_t> _finished_mining_time{ 0 };  // nanoseconds
+    std::atomic<std::int64_t> _current_mining_start{ -1 }; // nanoseconds since the steady clock epoch, -1 if idle
     //===================
     void worker();
     //===================
@@ -109,16 +335,21 @@ class MinerWorker
 
 
 Miner::Miner(base::json::Value config, Miner::HandlerType handler)
-  : _common_state{ { impl::Task::NONE, std::nullopt, std::nullopt }, std::move(handler) }
+  : _settings{ readSettings(config) }
+  , _common_state{ { impl::Task::NONE, std::nullopt, std::nullopt }, std::move(handler), _settings.threads }
 {
     // setting up threads
-    std::size_t num_threads = calcThreadsNum(std::move(config));
-
-    for (std::size_t i = 0; i < num_threads; ++i) {
-        _workers.emplace_front(_common_state);
+    for (std::size_t i = 0; i < _settings.threads; ++i) {
+        std::optional<unsigned> cpu;
+        if (!_settings.cpus.empty()) {
+            cpu = _settings.cpus[i % _settings.cpus.size()];
+        }
+        _workers.emplace_front(
+          _common_state, impl::getNonceStripe(i, _settings.threads), _settings.on_stripe_exhausted, cpu);
     }
 
-    LOG_INFO << "Miner is running on " << num_threads << " threads";
+    LOG_INFO << "Miner is running on " << _settings.threads << " threads"
+             << (_settings.cpus.empty() ? "" : ", pinned to cpus");
 }
 
 
@@ -140,6 +371,25 @@ void Miner::dropJob()
 }
 
 
+void Miner::registerStaleSolution()
+{
+    _stale_solutions.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+MinerStatistics Miner::getStatistics() const
+{
+    MinerStatistics ret;
+    for (const auto& worker : _workers) {
+        ret.workers.push_back(worker.getStatistics());
+    }
+    ret.found_solutions = _common_state.getFoundSolutionsNumber();
+    ret.stale_solutions = _stale_solutions.load(std::memory_order_relaxed);
+    ret.job_switch_latency = _common_state.getJobSwitchLatency();
+    return ret;
+}
+
+
 void Miner::stop()
 {
     _common_state.setCommonData({ impl::Task::EXIT, std::nullopt, std::nullopt });
@@ -150,8 +400,14 @@ void Miner::stop()
 namespace impl
 {
 
-MinerWorker::MinerWorker(CommonState& common_state)
+MinerWorker::MinerWorker(CommonState& common_state,
+                         NonceStripe stripe,
+                         StripeExhaustedAction on_stripe_exhausted,
+                         std::optional<unsigned> cpu)
   : _common_state{ common_state }
+  , _stripe{ stripe }
+  , _on_stripe_exhausted{ on_stripe_exhausted }
+  , _cpu{ cpu }
 {
     _worker_thread = std::thread(&MinerWorker::worker, this);
 }
@@ -165,10 +421,24 @@ MinerWorker::~MinerWorker()
 }
 
 
+MinerStatistics::Worker MinerWorker::getStatistics() const
+{
+    std::chrono::nanoseconds mining_time{ _finished_mining_time.load(std::memory_order_relaxed) };
+    if (auto start = _current_mining_start.load(std::memory_order_relaxed); start >= 0) {
+        mining_time += std::chrono::steady_clock::now().time_since_epoch() - std::chrono::nanoseconds{ start };
+    }
+    return { _hashes.load(std::memory_order_relaxed),
+             std::chrono::duration_cast<std::chrono::microseconds>(mining_time) };
+}
+
+
 void MinerWorker::worker()
 {
+    if (_cpu) {
+        pinCurrentThread(*_cpu);
+    }
+
     bool is_stopping{ false };
-    std::mt19937_64 mt{ std::random_device{}() };
 
     std::size_t last_read_version{ 0 };
     CommonData data;
@@ -194,14 +464,58 @@ void MinerWorker::worker()
                 ASSERT(data.complexity);
                 lk::MutableBlock& b = data.block_to_mine.value();
                 const auto complexity = data.complexity->getComparer();
-                auto attempting_nonce = mt();
+                // transactions digest and hashing of everything before the nonce are done once per job
+                auto prefix_hashing_state = lk::PowHeader{ b }.getPrefixHashingState();
+                lk::PowHeader::HashesBatch hashes;
+                auto attempting_nonce = _stripe.first;
+
+                const auto mining_start = std::chrono::steady_clock::now().time_since_epoch();
+                _current_mining_start.store(std::chrono::nanoseconds{ mining_start }.count(),
+                                            std::memory_order_relaxed);
+                auto hashes_done = _hashes.load(std::memory_order_relaxed);
                 while (last_read_version == _common_state.getVersion()) {
-                    b.setNonce(attempting_nonce++); // overflow must go by modulo 2, since unsigned
-                    if (base::Sha256::compute(base::toBytes(b)).getBytes() < complexity) {
-                        lk::BlockBuilder builder(b);
-                        _common_state.callHandlerAndDrop(std::move(builder).buildImmutable());
+                    const auto first_nonce = attempting_nonce;
+                    const bool is_stripe_exhausted = _stripe.last - first_nonce < hashes.size();
+                    // nonces past the end of the stripe belong to the next worker, so their hashes are not checked
+                    const auto hashes_to_check =
+                      is_stripe_exhausted ? static_cast<std::size_t>(_stripe.last - first_nonce + 1) : hashes.size();
+                    lk::PowHeader::computeHashes(prefix_hashing_state, first_nonce, hashes);
+                    hashes_done += hashes_to_check;
+                    _hashes.store(hashes_done, std::memory_order_relaxed);
+
+                    bool is_found{ false };
+                    for (std::size_t i = 0; i < hashes_to_check; ++i) {
+                        if (hashes[i] < complexity) {
+                            b.setNonce(first_nonce + i);
+                            lk::BlockBuilder builder(b);
+                            _common_state.callHandlerAndDrop(std::move(builder).buildImmutable());
+                            is_found = true;
+                            break;
+                        }
+                    }
+                    if (is_found) {
+                        break;
+                    }
+
+                    if (!is_stripe_exhausted) {
+                        attempting_nonce += hashes.size();
+                    }
+                    else if (_on_stripe_exhausted == StripeExhaustedAction::ROLL_TIMESTAMP) {
+                        // the header is changed, so the same stripe gives new hashes
+                        b.setTimestamp(base::Time{ b.getTimestamp().getSeconds() + 1 });
+                        prefix_hashing_state = lk::PowHeader{ b }.getPrefixHashingState();
+                        attempting_nonce = _stripe.first;
+                    }
+                    else {
+                        LOG_DEBUG << "Miner thread exhausted its nonce stripe, waiting for a new job";
+                        break;
                     }
                 }
+
+                const auto mining_time = std::chrono::steady_clock::now().time_since_epoch() - mining_start;
+                _finished_mining_time.fetch_add(std::chrono::nanoseconds{ mining_time }.count(),
+                                                std::memory_order_relaxed);
+                _current_mining_start.store(-1, std::memory_order_relaxed);
                 break;
             }
             default: {
@@ -7,7 +7,9 @@
 #include "base/bytes.hpp"
 #include "base/json.hpp"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <forward_list>
@@ -15,6 +17,30 @@
 #include <optional>
 #include <shared_mutex>
 #include <thread>
+#include <vector>
+
+
+struct MinerStatistics
+{
+    struct Worker
+    {
+        std::uint64_t hashes;                  // number of tried nonces since the start
+        std::chrono::microseconds mining_time; // spent on finding nonces, so hashes / mining_time is the hashrate
+    };
+
+    /*
+     * Job switch latency is the time from a new task (findNonce, dropJob or a found nonce) until every worker
+     * picked it up. Bucket 0 counts switches under 1 microsecond, bucket i counts [2^(i-1), 2^i) microseconds,
+     * the last bucket counts everything longer.
+     */
+    static constexpr std::size_t LATENCY_BUCKETS_NUMBER = 24;
+
+    std::vector<Worker> workers;
+    std::uint64_t found_solutions;
+    std::uint64_t stale_solutions; // found, but rejected on addition, e.g. the chain had moved on
+    std::array<std::uint64_t, LATENCY_BUCKETS_NUMBER> job_switch_latency;
+};
+
 
 namespace impl
 {
@@ -31,6 +57,47 @@ enum class Task
 };
 
 
+/*
+ * Every worker searches its own stripe of the nonce space, so no nonce is tried twice by different workers.
+ * The last stripe takes the remainder of the division.
+ */
+struct NonceStripe
+{
+    lk::NonceInt first;
+    lk::NonceInt last; // inclusive, so that the last stripe can end at the maximum nonce
+};
+
+NonceStripe getNonceStripe(std::size_t worker_index, std::size_t workers_number) noexcept;
+
+
+enum class StripeExhaustedAction
+{
+    ROLL_TIMESTAMP, // add a second to the block timestamp and go through the stripe again
+    WAIT_FOR_JOB    // stop hashing until the next findNonce
+};
+
+
+struct MinerSettings
+{
+    std::size_t threads;
+    std::vector<unsigned> cpus; // workers are pinned to them round-robin, not pinned if empty
+    StripeExhaustedAction on_stripe_exhausted;
+};
+
+
+class LatencyHistogram
+{
+  public:
+    using Counts = std::array<std::uint64_t, MinerStatistics::LATENCY_BUCKETS_NUMBER>;
+    //===================
+    void record(std::chrono::nanoseconds duration) noexcept;
+    Counts getCounts() const noexcept;
+    //===================
+  private:
+    std::array<std::atomic<std::uint64_t>, MinerStatistics::LATENCY_BUCKETS_NUMBER> _counts{};
+};
+
+
 struct CommonData
 {
     impl::Task task;
@@ -43,7 +110,7 @@ class CommonState
 {
   public:
     //===================
-    CommonState(CommonData&& initial_state, MinerHandlerType handler);
+    CommonState(CommonData&& initial_state, MinerHandlerType handler, std::size_t workers_number);
     //===================
     std::size_t getVersion() const;
     //===================
@@ -55,6 +122,9 @@ class CommonState
     //===================
     void waitAndReadNewData(std::size_t& last_read_version, CommonData& data);
     //===================
+    LatencyHistogram::Counts getJobSwitchLatency() const noexcept;
+    std::uint64_t getFoundSolutionsNumber() const noexcept;
+    //===================
   private:
     //===================
     mutable std::shared_mutex _state_mutex;
@@ -64,6 +134,14 @@ class CommonState
     CommonData _common_data;
     MinerHandlerType _handler;
     //===================
+    const std::size_t _workers_number;
+    std::chrono::steady_clock::time_point _version_changed_at;
+    std::atomic<std::size_t> _workers_left_to_pick_up{ 0 };
+    LatencyHistogram _job_switch_latency;
+    std::atomic<std::uint64_t> _found_solutions{ 0 };
+    //===================
+    void onVersionChanged();
+    //===================
 };
 
 } // namespace impl
@@ -82,9 +160,15 @@ class Miner
     void findNonce(const lk::MutableBlock& block_without_nonce, const lk::Complexity& complexity);
     void dropJob();
     //===================
+    // called by the owner when a block passed to the handler wasn't accepted
+    void registerStaleSolution();
+    MinerStatistics getStatistics() const;
+    //===================
   private:
     //===================
+    const impl::MinerSettings _settings;
     impl::CommonState _common_state;
+    std::atomic<std::uint64_t> _stale_solutions{ 0 };
     //===================
     std::forward_list<impl::MinerWorker> _workers;
     //===================
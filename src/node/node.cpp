@@ -3,19 +3,65 @@
 #include <functional>
 #include <string>
 
+namespace
+{
+
+std::chrono::milliseconds getMiningJobUpdateInterval(const base::json::Value& config)
+{
+    if (config.has_object_field("miner") && config.at("miner").has_number_field("update_interval_ms")) {
+        auto interval_value = config.at("miner").at("update_interval_ms").as_number();
+        if (interval_value.is_uint64()) {
+            return std::chrono::milliseconds{ interval_value.to_uint64() };
+        }
+        RAISE_ERROR(base::InvalidArgument, "miner \"update_interval_ms\" must be a non-negative integer");
+    }
+    return std::chrono::milliseconds{ base::config::MINER_JOB_UPDATE_INTERVAL };
+}
+
+
+lk::Balance calcFeeValue(const lk::TransactionsSet& txs)
+{
+    lk::Balance ret{ 0 };
+    for (const auto& tx : txs) {
+        ret += tx.getFee();
+    }
+    return ret;
+}
+
+} // namespace
+
+
 Node::Node(base::json::Value config)
   : _config{ std::move(config) }
   , _core{ std::move(_config["core"]) }
   , _public_service{ std::move(_config["websocket"]), _core }
+  , _mining_job_update_interval{ getMiningJobUpdateInterval(_config) }
 {
     if (!_config.has_object_field("miner")) {
         RAISE_ERROR(base::InvalidArgument, "config file is't contain miner node");
     }
     _miner = std::make_unique<Miner>(std::move(_config["miner"]),
                                      std::bind(&Node::onBlockMine, this, std::placeholders::_1));
+    _public_service.attachMiner(*_miner);
 
     _core.subscribeToNewPendingTransaction(std::bind(&Node::onNewTransactionReceived, this, std::placeholders::_1));
+    _core.subscribeToNewPendingTransactions(std::bind(&Node::onNewTransactionsReceived, this, std::placeholders::_1));
     _core.subscribeToBlockAddition(std::bind(&Node::onNewBlock, this, std::placeholders::_1));
+
+    _mining_job_updater = std::thread(&Node::miningJobUpdaterLoop, this);
+}
+
+
+Node::~Node()
+{
+    {
+        std::lock_guard lk{ _mining_job_update_mutex };
+        _is_stopping = true;
+    }
+    _mining_job_update_cv.notify_one();
+    if (_mining_job_updater.joinable()) {
+        _mining_job_updater.join();
+    }
 }
 
 
@@ -37,34 +83,84 @@ void Node::run()
 
 void Node::onBlockMine(lk::ImmutableBlock&& block)
 {
-    LOG_DEBUG << "Block " << base::Sha256::compute(base::toBytes(block)) << " mined";
+    LOG_DEBUG << "Block " << block.getHash() << " mined";
+    {
+        // the miner drops its job when a nonce is found
+        std::lock_guard lk{ _mining_job_mutex };
+        _mining_job.reset();
+    }
     [[maybe_unused]] auto r = _core.tryAddMinedBlock(block);
     if (r != lk::Blockchain::AdditionResult::ADDED) {
-        LOG_DEBUG << "Block " << base::Sha256::compute(base::toBytes(block)) << " addition resulted in error code "
-                  << static_cast<int>(r);
+        _miner->registerStaleSolution();
+        LOG_DEBUG << "Block " << block.getHash() << " addition resulted in error code " << static_cast<int>(r);
     }
 }
 
 
 void Node::onNewTransactionReceived(const lk::Transaction&)
 {
-    auto [block, complexity] = _core.getMiningData();
-    if (!block.getTransactions().isEmpty()) {
-        _miner->findNonce(block, complexity);
-    }
-    else {
-        _miner->dropJob();
+    requestMiningJobUpdate();
+}
+
+
+void Node::onNewTransactionsReceived(const lk::TransactionsSet&)
+{
+    requestMiningJobUpdate();
+}
+
+
+void Node::requestMiningJobUpdate()
+{
+    {
+        std::lock_guard lk{ _mining_job_update_mutex };
+        _is_mining_job_update_requested = true;
     }
+    _mining_job_update_cv.notify_one();
 }
 
 
 void Node::onNewBlock(const lk::ImmutableBlock&)
 {
+    // the running job mines on top of an old block, so it's replaced right away
+    updateMiningJob();
+}
+
+
+void Node::updateMiningJob()
+{
+    std::lock_guard lk{ _mining_job_mutex };
     auto [block, complexity] = _core.getMiningData();
-    if (!block.getTransactions().isEmpty()) {
-        _miner->findNonce(block, complexity);
-    }
-    else {
+    if (block.getTransactions().isEmpty()) {
         _miner->dropJob();
+        _mining_job.reset();
+        return;
+    }
+
+    auto fee_value = calcFeeValue(block.getTransactions());
+    if (_mining_job && _mining_job->prev_block_hash == block.getPrevBlockHash() &&
+        fee_value <= _mining_job->fee_value) {
+        // restarting the workers is worth it only for a more valuable block
+        return;
+    }
+    _mining_job = MiningJob{ block.getPrevBlockHash(), std::move(fee_value) };
+    _miner->findNonce(block, complexity);
+}
+
+
+void Node::miningJobUpdaterLoop()
+{
+    std::unique_lock lk{ _mining_job_update_mutex };
+    while (true) {
+        _mining_job_update_cv.wait(lk, [this] { return _is_mining_job_update_requested || _is_stopping; });
+        // transactions that come during the interval are taken by the same update
+        _mining_job_update_cv.wait_for(lk, _mining_job_update_interval, [this] { return _is_stopping; });
+        if (_is_stopping) {
+            return;
+        }
+        _is_mining_job_update_requested = false;
+
+        lk.unlock();
+        updateMiningJob();
+        lk.lock();
     }
 }
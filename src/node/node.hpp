@@ -7,10 +7,17 @@
 
 #include "base/crypto.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 class Node
 {
   public:
     explicit Node(base::json::Value config);
+    ~Node();
     void run();
 
   private:
@@ -22,7 +29,29 @@ class Node
     //---------------------------
     std::unique_ptr<Miner> _miner;
     //---------------------------
+    struct MiningJob
+    {
+        base::Sha256 prev_block_hash;
+        lk::Balance fee_value;
+    };
+
+    std::mutex _mining_job_mutex;
+    std::optional<MiningJob> _mining_job; // the one being mined, if any
+    //---------------------------
+    // new pending transactions are coalesced: the mining job is rebuilt at most once per the interval
+    const std::chrono::milliseconds _mining_job_update_interval;
+    std::mutex _mining_job_update_mutex;
+    std::condition_variable _mining_job_update_cv;
+    bool _is_mining_job_update_requested{ false };
+    bool _is_stopping{ false };
+    std::thread _mining_job_updater;
+    //---------------------------
     void onBlockMine(lk::ImmutableBlock&& block);
     void onNewTransactionReceived(const lk::Transaction& tx);
+    void onNewTransactionsReceived(const lk::TransactionsSet& txs);
     void onNewBlock(const lk::ImmutableBlock& block);
+    //---------------------------
+    void requestMiningJobUpdate();
+    void updateMiningJob();
+    void miningJobUpdaterLoop();
 };
\ No newline at end of file
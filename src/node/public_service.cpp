@@ -6,6 +6,36 @@
 #include "base/hash.hpp"
 #include "base/log.hpp"
 
+namespace
+{
+
+base::json::Value serializeMinerStatistics(const MinerStatistics& statistics)
+{
+    auto result = base::json::Value::object();
+    std::vector<base::json::Value> workers_value;
+    workers_value.reserve(statistics.workers.size());
+    for (const auto& worker : statistics.workers) {
+        auto worker_value = base::json::Value::object();
+        worker_value["hashes"] = base::json::Value::number(worker.hashes);
+        worker_value["mining_time_us"] =
+          base::json::Value::number(static_cast<std::uint64_t>(worker.mining_time.count()));
+        workers_value.emplace_back(std::move(worker_value));
+    }
+    result["workers"] = base::json::Value::array(workers_value);
+    result["found_solutions"] = base::json::Value::number(statistics.found_solutions);
+    result["stale_solutions"] = base::json::Value::number(statistics.stale_solutions);
+    std::vector<base::json::Value> latency_value;
+    latency_value.reserve(statistics.job_switch_latency.size());
+    for (auto count : statistics.job_switch_latency) {
+        latency_value.emplace_back(base::json::Value::number(count));
+    }
+    result["job_switch_latency"] = base::json::Value::array(latency_value);
+    return result;
+}
+
+} // namespace
+
+
 namespace tasks
 {
 
@@ -183,6 +213,60 @@ const std::string& PushTransactionTask::name() const noexcept
 }
 
 
+PushTransactionsTask::PushTransactionsTask(websocket::SessionId session_id,
+                                           websocket::QueryId query_id,
+                                           base::json::Value&& args)
+  : Task{ session_id, query_id, std::move(args) }
+{}
+
+
+void PushTransactionsTask::prepareArgs()
+{
+    if (!_args.has_array_field("transactions")) {
+        RAISE_ERROR(base::InvalidArgument, "args json is not contain an array \"transactions\" member");
+    }
+    const auto& txs_json_value = _args["transactions"].as_array();
+    if (txs_json_value.size() > base::config::PUBLIC_SERVICE_PUSH_BATCH_MAX_SIZE) {
+        RAISE_ERROR(base::InvalidArgument,
+                    "args json \"transactions\" member must have not more than " +
+                      std::to_string(base::config::PUBLIC_SERVICE_PUSH_BATCH_MAX_SIZE) + " items");
+    }
+
+    std::vector<lk::Transaction> txs;
+    txs.reserve(txs_json_value.size());
+    for (const auto& tx_json_value : txs_json_value) {
+        txs.push_back(websocket::deserializeTransaction(tx_json_value));
+    }
+    _txs = std::move(txs);
+}
+
+
+void PushTransactionsTask::execute(PublicService& service)
+{
+    const auto& txs = _txs.value();
+    const auto statuses = service._core.addPendingTransactions(txs);
+
+    std::vector<base::json::Value> statuses_value;
+    statuses_value.reserve(statuses.size());
+    for (std::size_t i = 0; i < statuses.size(); ++i) {
+        auto status_value = websocket::serializeTransactionStatus(statuses[i]);
+        status_value["hash"] = websocket::serializeHash(txs[i].hashOfTransaction());
+        statuses_value.emplace_back(std::move(status_value));
+    }
+
+    auto answer = base::json::Value::object();
+    answer["statuses"] = base::json::Value::array(statuses_value);
+    service.sendCorrectResponse(_session_id, _query_id, std::move(answer));
+}
+
+
+const std::string& PushTransactionsTask::name() const noexcept
+{
+    static const std::string name("PushTransactionsTask");
+    return name;
+}
+
+
 FindTransactionStatusTask::FindTransactionStatusTask(websocket::SessionId session_id,
                                                      websocket::QueryId query_id,
                                                      base::json::Value&& args)
@@ -355,6 +439,115 @@ const std::string& AccountInfoCallTask::name() const noexcept
 }
 
 
+AccountTransactionsCallTask::AccountTransactionsCallTask(websocket::SessionId session_id,
+                                                         websocket::QueryId query_id,
+                                                         base::json::Value&& args)
+  : Task{ session_id, query_id, std::move(args) }
+{}
+
+
+void AccountTransactionsCallTask::prepareArgs()
+{
+    if (!_args.has_string_field("address")) {
+        RAISE_ERROR(base::InvalidArgument, "args json is not contain a string\"address\" member");
+    }
+    _address = websocket::deserializeAddress(_args["address"].as_string());
+
+    if (_args.has_number_field("from")) {
+        auto from_json_value = _args["from"].as_number();
+        if (!from_json_value.is_uint64()) {
+            RAISE_ERROR(base::InvalidArgument, "args json \"from\" member is not a uint type");
+        }
+        _first_sequence_number = from_json_value.to_uint64();
+    }
+
+    if (_args.has_number_field("count")) {
+        auto count_json_value = _args["count"].as_number();
+        if (!count_json_value.is_uint64() ||
+            count_json_value.to_uint64() > base::config::PUBLIC_SERVICE_HISTORY_PAGE_MAX_SIZE) {
+            RAISE_ERROR(base::InvalidArgument,
+                        "args json \"count\" member must be a uint not greater than " +
+                          std::to_string(base::config::PUBLIC_SERVICE_HISTORY_PAGE_MAX_SIZE));
+        }
+        _count = count_json_value.to_uint64();
+    }
+}
+
+
+void AccountTransactionsCallTask::execute(PublicService& service)
+{
+    auto transactions_hashes = service._core.getAccountTransactions(_address.value(), _first_sequence_number, _count);
+    auto answer =
+      websocket::serializeAccountTransactions(_address.value(), _first_sequence_number, transactions_hashes);
+    service.sendCorrectResponse(_session_id, _query_id, std::move(answer));
+}
+
+
+const std::string& AccountTransactionsCallTask::name() const noexcept
+{
+    static const std::string name("AccountTransactionsCallTask");
+    return name;
+}
+
+
+MinerStatisticsCallTask::MinerStatisticsCallTask(websocket::SessionId session_id,
+                                                 websocket::QueryId query_id,
+                                                 base::json::Value&& args)
+  : Task{ session_id, query_id, std::move(args) }
+{}
+
+
+void MinerStatisticsCallTask::prepareArgs()
+{
+    // Do nothing
+}
+
+
+void MinerStatisticsCallTask::execute(PublicService& service)
+{
+    const auto* miner = service._miner.load();
+    if (!miner) {
+        RAISE_ERROR(base::LogicError, "miner is not running");
+    }
+    auto answer = serializeMinerStatistics(miner->getStatistics());
+    service.sendCorrectResponse(_session_id, _query_id, std::move(answer));
+}
+
+
+const std::string& MinerStatisticsCallTask::name() const noexcept
+{
+    static const std::string name("MinerStatisticsCallTask");
+    return name;
+}
+
+
+BlocksCacheStatisticsCallTask::BlocksCacheStatisticsCallTask(websocket::SessionId session_id,
+                                                             websocket::QueryId query_id,
+                                                             base::json::Value&& args)
+  : Task{ session_id, query_id, std::move(args) }
+{}
+
+
+void BlocksCacheStatisticsCallTask::prepareArgs()
+{
+    // Do nothing
+}
+
+
+void BlocksCacheStatisticsCallTask::execute(PublicService& service)
+{
+    auto answer = websocket::serializeBlocksCacheStats(service._core.getBlocksCacheStats());
+    service.sendCorrectResponse(_session_id, _query_id, std::move(answer));
+}
+
+
+const std::string& BlocksCacheStatisticsCallTask::name() const noexcept
+{
+    static const std::string name("BlocksCacheStatisticsCallTask");
+    return name;
+}
+
+
 FeeInfoCallTask::FeeInfoCallTask(websocket::SessionId session_id,
                                          websocket::QueryId query_id,
                                          base::json::Value&& args)
@@ -590,6 +783,12 @@ void PublicService::run()
 }
 
 
+void PublicService::attachMiner(const Miner& miner)
+{
+    _miner = &miner;
+}
+
+
 void PublicService::stop()
 {
     if (_worker.joinable()) {
@@ -633,6 +832,20 @@ void PublicService::on_session_request(websocket::SessionId session_id,
         case websocket::Command::CALL_ACCOUNT_INFO:
             _input_tasks.push(std::make_unique<tasks::AccountInfoCallTask>(session_id, query_id, std::move(args)));
             break;
+        case websocket::Command::CALL_ACCOUNT_TRANSACTIONS:
+            _input_tasks.push(
+              std::make_unique<tasks::AccountTransactionsCallTask>(session_id, query_id, std::move(args)));
+            break;
+        case websocket::Command::CALL_MINER_STATISTICS:
+            _input_tasks.push(std::make_unique<tasks::MinerStatisticsCallTask>(session_id, query_id, std::move(args)));
+            break;
+        case websocket::Command::CALL_BLOCKS_CACHE_STATISTICS:
+            _input_tasks.push(
+              std::make_unique<tasks::BlocksCacheStatisticsCallTask>(session_id, query_id, std::move(args)));
+            break;
+        case websocket::Command::CALL_PUSH_TRANSACTIONS:
+            _input_tasks.push(std::make_unique<tasks::PushTransactionsTask>(session_id, query_id, std::move(args)));
+            break;
         case websocket::Command::CALL_FEE_INFO:
             _input_tasks.push(std::make_unique<tasks::FeeInfoCallTask>(session_id, query_id, std::move(args)));
             break;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "miner.hpp"
+
 #include "core/core.hpp"
 #include "core/transaction.hpp"
 
@@ -7,6 +9,7 @@
 #include "websocket/session.hpp"
 #include "websocket/tools.hpp"
 
+#include "base/config.hpp"
 #include "base/utility.hpp"
 
 #include <atomic>
@@ -84,6 +87,22 @@ class PushTransactionTask final : public Task
 };
 
 
+// all transactions are admitted at once and a single answer has a status for each of them
+class PushTransactionsTask final : public Task
+{
+  public:
+    PushTransactionsTask(websocket::SessionId session_id, websocket::QueryId query_id, base::json::Value&& args);
+
+  protected:
+    void prepareArgs() override;
+    void execute(PublicService& service) override;
+    const std::string& name() const noexcept override;
+
+  private:
+    std::optional<std::vector<lk::Transaction>> _txs;
+};
+
+
 class FindTransactionStatusTask final : public Task
 {
   public:
@@ -150,6 +169,51 @@ class AccountInfoCallTask final : public Task
 };
 
 
+class AccountTransactionsCallTask final : public Task
+{
+  public:
+    AccountTransactionsCallTask(websocket::SessionId session_id,
+                                websocket::QueryId query_id,
+                                base::json::Value&& args);
+
+  protected:
+    void prepareArgs() override;
+    void execute(PublicService& service) override;
+    const std::string& name() const noexcept override;
+
+  private:
+    std::optional<lk::Address> _address;
+    std::uint64_t _first_sequence_number{ 0 };
+    std::size_t _count{ base::config::PUBLIC_SERVICE_HISTORY_PAGE_MAX_SIZE };
+};
+
+
+class MinerStatisticsCallTask final : public Task
+{
+  public:
+    MinerStatisticsCallTask(websocket::SessionId session_id, websocket::QueryId query_id, base::json::Value&& args);
+
+  protected:
+    void prepareArgs() override;
+    void execute(PublicService& service) override;
+    const std::string& name() const noexcept override;
+};
+
+
+class BlocksCacheStatisticsCallTask final : public Task
+{
+  public:
+    BlocksCacheStatisticsCallTask(websocket::SessionId session_id,
+                                  websocket::QueryId query_id,
+                                  base::json::Value&& args);
+
+  protected:
+    void prepareArgs() override;
+    void execute(PublicService& service) override;
+    const std::string& name() const noexcept override;
+};
+
+
 class FeeInfoCallTask final : public Task
 {
   public:
@@ -237,8 +301,12 @@ class PublicService
     friend tasks::NodeInfoSubscribeTask;
     friend tasks::NodeInfoUnsubscribeTask;
     friend tasks::AccountInfoCallTask;
+    friend tasks::AccountTransactionsCallTask;
+    friend tasks::MinerStatisticsCallTask;
+    friend tasks::BlocksCacheStatisticsCallTask;
     friend tasks::FeeInfoCallTask;
     friend tasks::PushTransactionTask;
+    friend tasks::PushTransactionsTask;
     friend tasks::AccountInfoSubscribeTask;
     friend tasks::AccountInfoUnsubscribeTask;
     friend tasks::UnsubscribeTransactionStatusUpdateTask;
@@ -252,6 +320,9 @@ class PublicService
     void run();
     void stop();
 
+    // statistics of the miner are served only after it's attached
+    void attachMiner(const Miner& miner);
+
     void sendCorrectResponse(websocket::SessionId session_id, websocket::QueryId query_id, base::json::Value&& result);
     void sendErrorResponse(websocket::SessionId session_id,
                            websocket::QueryId query_id,
@@ -259,6 +330,7 @@ class PublicService
 
   private:
     lk::Core& _core;
+    std::atomic<const Miner*> _miner{ nullptr };
 
     websocket::SessionId _last_given_session_id{ 0 };
     std::unordered_map<websocket::SessionId, std::unique_ptr<websocket::WebSocketSession>> _running_sessions;
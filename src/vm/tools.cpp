@@ -300,6 +300,12 @@ evmc::bytes32 toEvmcBytes32(const base::FixedBytes<32>& data)
 }
 
 
+base::FixedBytes<32> toStorageSlot(const evmc::bytes32& bytes)
+{
+    return base::FixedBytes<32>(bytes.bytes, std::size(bytes.bytes));
+}
+
+
 lk::Balance toBalance(evmc_uint256be value)
 {
     auto val = base::toHex<base::Bytes>(toBytes(value));
@@ -394,9 +400,7 @@ base::Bytes encode(uint8_t value)
 
 lk::Address toNativeAddress(const evmc::address& addr)
 {
-    base::Bytes raw_address(addr.bytes, lk::Address::LENGTH_IN_BYTES);
-    lk::Address address(raw_address);
-    return address;
+    return lk::Address{ base::FixedBytes<lk::Address::LENGTH_IN_BYTES>(addr.bytes, std::size(addr.bytes)) };
 }
 
 
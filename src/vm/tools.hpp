@@ -26,6 +26,8 @@ evmc::bytes32 toEvmcBytes32(const base::Bytes& data);
 
 evmc::bytes32 toEvmcBytes32(const base::FixedBytes<32>& data);
 
+base::FixedBytes<32> toStorageSlot(const evmc::bytes32& bytes);
+
 lk::Balance toBalance(evmc_uint256be value);
 
 evmc_uint256be toEvmcUint256(const lk::Balance& balance);
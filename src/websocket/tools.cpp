@@ -151,6 +151,14 @@ base::json::Value serializeCommandName(Command::Id command)
             return base::json::Value::string("last_block_info");
         case Command::Name::LOGIN:
             return base::json::Value::string("login");
+        case Command::Name::ACCOUNT_TRANSACTIONS:
+            return base::json::Value::string("account_transactions");
+        case Command::Name::MINER_STATISTICS:
+            return base::json::Value::string("miner_statistics");
+        case Command::Name::PUSH_TRANSACTIONS:
+            return base::json::Value::string("push_transactions");
+        case Command::Name::BLOCKS_CACHE_STATISTICS:
+            return base::json::Value::string("blocks_cache_statistics");
         default:
             RAISE_ERROR(base::LogicError, "used unexpected command name");
     }
@@ -184,6 +192,18 @@ websocket::Command::Name deserializeCommandName(const std::string& command_name_
     if (command_name_str == "login") {
         return websocket::Command::Name::LOGIN;
     }
+    if (command_name_str == "account_transactions") {
+        return websocket::Command::Name::ACCOUNT_TRANSACTIONS;
+    }
+    if (command_name_str == "miner_statistics") {
+        return websocket::Command::Name::MINER_STATISTICS;
+    }
+    if (command_name_str == "push_transactions") {
+        return websocket::Command::Name::PUSH_TRANSACTIONS;
+    }
+    if (command_name_str == "blocks_cache_statistics") {
+        return websocket::Command::Name::BLOCKS_CACHE_STATISTICS;
+    }
     RAISE_ERROR(base::InvalidArgument, std::string("not any command name found by ") + command_name_str);
 }
 
@@ -452,12 +472,7 @@ base::json::Value serializeAccountInfo(const lk::AccountInfo& account_info)
     result["balance"] = serializeBalance(account_info.balance);
     result["nonce"] = base::json::Value::number(account_info.nonce);
     result["type"] = serializeAccountType(account_info.type);
-    std::vector<base::json::Value> txs_hashes_value;
-
-    for (const auto& tx_hash : account_info.transactions_hashes) {
-        txs_hashes_value.emplace_back(std::move(serializeHash(tx_hash)));
-    }
-    result["transaction_hashes"] = base::json::Value::array(txs_hashes_value);
+    result["transactions_count"] = base::json::Value::number(account_info.transactions_count);
     return result;
 }
 
@@ -489,20 +504,67 @@ lk::AccountInfo deserializeAccountInfo(base::json::Value input)
     }
     auto address = deserializeAddress(input["address"].as_string());
 
-    if (!input.has_array_field("transaction_hashes")) {
-        RAISE_ERROR(base::InvalidArgument, "AccountInfo json is not contain an array \"transaction_hashes\" member");
+    if (!input.has_number_field("transactions_count")) {
+        RAISE_ERROR(base::InvalidArgument, "AccountInfo json is not contain an uint \"transactions_count\" member");
     }
-    std::vector<base::Sha256> transactions_hashes;
-    for (auto& tx_hash_value : input["transaction_hashes"].as_array()) {
-        if (!tx_hash_value.is_string()) {
-            RAISE_ERROR(base::InvalidArgument, "AccountInfo \"transaction_hash\" one member is not a string type");
-        }
-        transactions_hashes.emplace_back(deserializeHash(tx_hash_value.as_string()));
+    auto transactions_count_json_value = input["transactions_count"].as_number();
+    if (!transactions_count_json_value.is_uint64()) {
+        RAISE_ERROR(base::InvalidArgument, "AccountInfo \"transactions_count\" member is not a uint type");
+    }
+    auto transactions_count = transactions_count_json_value.to_uint64();
+
+    return lk::AccountInfo{ account_type, std::move(address), std::move(balance), nonce, transactions_count };
+}
+
+
+base::json::Value serializeAccountTransactions(const lk::Address& address,
+                                               std::uint64_t first_sequence_number,
+                                               const std::vector<base::Sha256>& transactions_hashes)
+{
+    LOG_TRACE << "Serializing AccountTransactions";
+    auto result = base::json::Value::object();
+    result["address"] = serializeAddress(address);
+    result["first_sequence_number"] = base::json::Value::number(first_sequence_number);
+    std::vector<base::json::Value> txs_hashes_value;
+    txs_hashes_value.reserve(transactions_hashes.size());
+    for (const auto& tx_hash : transactions_hashes) {
+        txs_hashes_value.emplace_back(serializeHash(tx_hash));
     }
+    result["transactions_hashes"] = base::json::Value::array(txs_hashes_value);
+    return result;
+}
+
+
+base::json::Value serializeBlocksCacheStats(const lk::Blockchain::BlocksCacheStats& stats)
+{
+    LOG_TRACE << "Serializing BlocksCacheStats";
+    auto result = base::json::Value::object();
+    result["hits"] = base::json::Value::number(stats.hits);
+    result["misses"] = base::json::Value::number(stats.misses);
+    result["blocks_count"] = base::json::Value::number(stats.size);
+    result["bytes"] = base::json::Value::number(stats.weight);
+    result["capacity_bytes"] = base::json::Value::number(stats.capacity);
+    return result;
+}
+
 
-    return lk::AccountInfo{
-        account_type, std::move(address), std::move(balance), nonce, std::move(transactions_hashes)
+lk::Blockchain::BlocksCacheStats deserializeBlocksCacheStats(base::json::Value input)
+{
+    LOG_TRACE << "Deserializing BlocksCacheStats";
+    auto get_uint_field = [&input](const char* field) {
+        if (!input.has_number_field(field) || !input[field].as_number().is_uint64()) {
+            RAISE_ERROR(base::InvalidArgument,
+                        std::string("BlocksCacheStats json is not contain an uint \"") + field + "\" member");
+        }
+        return static_cast<std::size_t>(input[field].as_number().to_uint64());
     };
+    lk::Blockchain::BlocksCacheStats stats{};
+    stats.hits = get_uint_field("hits");
+    stats.misses = get_uint_field("misses");
+    stats.size = get_uint_field("blocks_count");
+    stats.weight = get_uint_field("bytes");
+    stats.capacity = get_uint_field("capacity_bytes");
+    return stats;
 }
 
 
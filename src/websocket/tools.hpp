@@ -78,6 +78,14 @@ base::json::Value serializeAccountInfo(const lk::AccountInfo& account_info);
 
 lk::AccountInfo deserializeAccountInfo(base::json::Value input);
 
+base::json::Value serializeAccountTransactions(const lk::Address& address,
+                                               std::uint64_t first_sequence_number,
+                                               const std::vector<base::Sha256>& transactions_hashes);
+
+base::json::Value serializeBlocksCacheStats(const lk::Blockchain::BlocksCacheStats& stats);
+
+lk::Blockchain::BlocksCacheStats deserializeBlocksCacheStats(base::json::Value input);
+
 base::json::Value serializeInfo(const NodeInfo& info);
 
 NodeInfo deserializeInfo(base::json::Value input);
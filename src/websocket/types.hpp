@@ -24,6 +24,10 @@ enum class Name : std::uint64_t
     ACCOUNT_INFO,
     FEE_INFO,
     LOGIN,
+    ACCOUNT_TRANSACTIONS,
+    MINER_STATISTICS,
+    PUSH_TRANSACTIONS,
+    BLOCKS_CACHE_STATISTICS,
     MAX = 128
 };
 
@@ -46,6 +50,18 @@ constexpr Id CALL_LAST_BLOCK_INFO = websocket::Command::Id(websocket::Command::T
 constexpr Id CALL_ACCOUNT_INFO = websocket::Command::Id(websocket::Command::Type::CALL) |
                                  websocket::Command::Id(websocket::Command::Name::ACCOUNT_INFO);
 
+constexpr Id CALL_ACCOUNT_TRANSACTIONS = websocket::Command::Id(websocket::Command::Type::CALL) |
+                                         websocket::Command::Id(websocket::Command::Name::ACCOUNT_TRANSACTIONS);
+
+constexpr Id CALL_MINER_STATISTICS = websocket::Command::Id(websocket::Command::Type::CALL) |
+                                     websocket::Command::Id(websocket::Command::Name::MINER_STATISTICS);
+
+constexpr Id CALL_BLOCKS_CACHE_STATISTICS = websocket::Command::Id(websocket::Command::Type::CALL) |
+                                            websocket::Command::Id(websocket::Command::Name::BLOCKS_CACHE_STATISTICS);
+
+constexpr Id CALL_PUSH_TRANSACTIONS = websocket::Command::Id(websocket::Command::Type::CALL) |
+                                      websocket::Command::Id(websocket::Command::Name::PUSH_TRANSACTIONS);
+
 constexpr Id CALL_FEE_INFO = websocket::Command::Id(websocket::Command::Type::CALL) |
                                  websocket::Command::Id(websocket::Command::Name::FEE_INFO);                        
 
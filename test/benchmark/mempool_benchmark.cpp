@@ -0,0 +1,126 @@
+#include "core/mempool.hpp"
+
+#include "base/config.hpp"
+#include "base/log.hpp"
+#include "base/program_options.hpp"
+#include "base/time.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/*
+ * Times the mempool operations done on every submitted transaction and on every added block, with the mempool
+ * filled up to the given number of pending transactions.
+ */
+
+namespace
+{
+
+lk::Address makeAddress(std::uint64_t index)
+{
+    base::Bytes bytes(lk::Address::LENGTH_IN_BYTES);
+    for (std::size_t i = 0; i < sizeof(index); ++i) {
+        bytes[i] = static_cast<base::Byte>(index >> (8 * i));
+    }
+    return lk::Address{ bytes };
+}
+
+
+template<typename F>
+void measure(const std::string& name, std::size_t operations_number, F&& run)
+{
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << elapsed / operations_number << " ns/op" << std::defaultfloat << '\n';
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    try {
+        base::initLog(base::Sink::FILE);
+
+        base::ProgramOptionsParser parser;
+        parser.addOption<std::uint64_t>("pending,n", 100'000, "Number of pending transactions");
+        parser.addOption<std::uint64_t>("senders,s", 1000, "Number of distinct senders");
+        parser.process(argc, argv);
+        if (parser.hasOption("help")) {
+            std::cout << parser.helpMessage() << std::endl;
+            return base::config::EXIT_OK;
+        }
+        const auto pending_number = parser.getValue<std::uint64_t>("pending");
+        const auto senders_number = std::max<std::uint64_t>(parser.getValue<std::uint64_t>("senders"), 1);
+
+        std::vector<lk::Transaction> txs;
+        txs.reserve(pending_number);
+        const auto to = makeAddress(senders_number);
+        for (std::uint64_t i = 0; i < pending_number; ++i) {
+            const lk::Fee fee = (i * 7919) % 1000 + 1;
+            txs.emplace_back(makeAddress(i % senders_number), to, i + 1, fee, base::Time::now(), base::Bytes{});
+        }
+
+        const lk::Mempool::Limits limits{ pending_number,
+                                          base::config::MEMPOOL_MAX_BYTES,
+                                          std::chrono::seconds{ base::config::MEMPOOL_TRANSACTION_LIFETIME } };
+        lk::Mempool mempool{ base::config::BC_MAX_TRANSACTIONS_IN_BLOCK, limits };
+        std::vector<lk::Transaction> evicted;
+        measure("add", txs.size(), [&] {
+            const auto now = base::Time::now();
+            for (const auto& tx : txs) {
+                mempool.add(tx, now, evicted);
+            }
+        });
+
+        std::size_t found = 0;
+        measure("find by hash", txs.size(), [&] {
+            for (const auto& tx : txs) {
+                found += mempool.contains(tx.hashOfTransaction());
+            }
+        });
+
+        std::size_t sender_txs = 0;
+        measure("transactions of a sender", senders_number, [&] {
+            for (std::uint64_t i = 0; i < senders_number; ++i) {
+                sender_txs += mempool.getSenderTransactions(makeAddress(i)).size();
+            }
+        });
+
+        const std::size_t blocks_number = 100;
+        measure("select block transactions", blocks_number, [&] {
+            for (std::size_t i = 0; i < blocks_number; ++i) {
+                found += mempool.getBlockTransactions().size();
+            }
+        });
+
+        // the mempool is full, so every addition evicts the transaction paying the least per byte
+        std::vector<lk::Transaction> better_txs;
+        for (std::uint64_t i = 0; i < blocks_number; ++i) {
+            better_txs.emplace_back(makeAddress(i), to, i + 1, 1'000'000, base::Time::now(), base::Bytes{});
+        }
+        measure("add with eviction", better_txs.size(), [&] {
+            const auto now = base::Time::now();
+            for (const auto& tx : better_txs) {
+                mempool.add(tx, now, evicted);
+            }
+        });
+
+        measure("remove a block of transactions", blocks_number, [&] {
+            for (std::size_t i = 0; i < blocks_number; ++i) {
+                mempool.remove(mempool.getBlockTransactions());
+            }
+        });
+
+        std::cout << "pending left: " << mempool.size() << ", checksum: " << found + sender_txs << '\n';
+        return base::config::EXIT_OK;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return base::config::EXIT_FAIL;
+    }
+}
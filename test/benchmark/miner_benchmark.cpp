@@ -0,0 +1,112 @@
+#include "node/miner.hpp"
+
+#include "core/block.hpp"
+#include "core/consensus.hpp"
+
+#include "base/config.hpp"
+#include "base/log.hpp"
+#include "base/program_options.hpp"
+#include "base/time.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+/*
+ * Runs the miner on synthetic blocks: no network, no database. A new job is given every switch interval, so
+ * besides the hashrate of every thread the job switch latency is measured the same way as in the node.
+ */
+
+namespace
+{
+
+lk::MutableBlock makeBlockToMine(lk::BlockDepth depth)
+{
+    lk::Address from{ base::Bytes(lk::Address::LENGTH_IN_BYTES) };
+    lk::Address to{ base::Bytes("to address bytes!!!!") };
+    lk::TransactionsSet txs;
+    txs.add(lk::Transaction{ from, to, 12398, 10, base::Time::now(), base::Bytes{} });
+    return lk::MutableBlock{ depth, 0, base::Sha256::compute(base::Bytes("previous block")), base::Time::now(), to,
+                             std::move(txs) };
+}
+
+
+void printStatistics(const MinerStatistics& statistics)
+{
+    double total_hashrate = 0;
+    std::size_t worker_index = 0;
+    for (const auto& worker : statistics.workers) {
+        const auto seconds = std::chrono::duration<double>(worker.mining_time).count();
+        const auto hashrate = seconds > 0 ? worker.hashes / seconds : 0;
+        total_hashrate += hashrate;
+        std::cout << "thread " << worker_index++ << ": " << worker.hashes << " hashes in " << seconds << " s, "
+                  << std::fixed << std::setprecision(0) << hashrate << " H/s" << std::defaultfloat << '\n';
+    }
+    std::cout << "total: " << std::fixed << std::setprecision(0) << total_hashrate << " H/s" << std::defaultfloat
+              << '\n';
+    std::cout << "found solutions: " << statistics.found_solutions << '\n';
+
+    std::cout << "job switch latency:\n";
+    for (std::size_t i = 0; i < statistics.job_switch_latency.size(); ++i) {
+        if (statistics.job_switch_latency[i] == 0) {
+            continue;
+        }
+        if (i == 0) {
+            std::cout << "  < 1 us";
+        }
+        else if (i + 1 == statistics.job_switch_latency.size()) {
+            std::cout << "  >= " << (std::uint64_t{ 1 } << (i - 1)) << " us";
+        }
+        else {
+            std::cout << "  [" << (std::uint64_t{ 1 } << (i - 1)) << ", " << (std::uint64_t{ 1 } << i) << ") us";
+        }
+        std::cout << ": " << statistics.job_switch_latency[i] << '\n';
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    try {
+        base::initLog(base::Sink::FILE);
+
+        base::ProgramOptionsParser parser;
+        parser.addOption<std::uint64_t>(
+          "threads,t", std::thread::hardware_concurrency(), "Number of mining threads");
+        parser.addOption<std::uint64_t>("duration,d", 10, "Benchmark duration in seconds");
+        parser.addOption<std::uint64_t>("switch,s", 500, "Interval between new jobs in milliseconds");
+        parser.addOption<std::uint64_t>("difficulty,c", 24, "Number of leading zero bits of a solution");
+        parser.process(argc, argv);
+        if (parser.hasOption("help")) {
+            std::cout << parser.helpMessage() << std::endl;
+            return base::config::EXIT_OK;
+        }
+
+        const auto duration = std::chrono::seconds{ parser.getValue<std::uint64_t>("duration") };
+        const auto switch_interval = std::chrono::milliseconds{ parser.getValue<std::uint64_t>("switch") };
+        const lk::Complexity complexity{ ~lk::Complexity::Densed{} >> parser.getValue<std::uint64_t>("difficulty") };
+
+        auto config = base::json::Value::object();
+        config["threads"] = base::json::Value::number(parser.getValue<std::uint64_t>("threads"));
+        Miner miner{ std::move(config), [](lk::ImmutableBlock&&) {} };
+
+        lk::BlockDepth depth = 1;
+        const auto finish = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < finish) {
+            miner.findNonce(makeBlockToMine(depth++), complexity);
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+              switch_interval, finish - std::chrono::steady_clock::now()));
+        }
+        miner.dropJob();
+
+        printStatistics(miner.getStatistics());
+        return base::config::EXIT_OK;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return base::config::EXIT_FAIL;
+    }
+}
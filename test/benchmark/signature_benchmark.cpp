@@ -0,0 +1,129 @@
+#include "core/signature_verifier.hpp"
+#include "core/transaction.hpp"
+
+#include "base/config.hpp"
+#include "base/crypto.hpp"
+#include "base/log.hpp"
+#include "base/program_options.hpp"
+#include "base/time.hpp"
+
+#include <include/secp256k1.h>
+#include <include/secp256k1_recovery.h>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+ * Measures how many transaction signatures are verified per second: the way it was done before, with a secp256k1
+ * context created for every signature, one by one with the shared context, in a batch, and on the verifier pool.
+ */
+
+namespace
+{
+
+// public key recovery as it was done before the shared context
+bool checkSignWithNewContext(const lk::Transaction& tx)
+{
+    std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> context(
+      secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY), secp256k1_context_destroy);
+
+    const auto& sig_data = tx.getSign();
+    auto hash = base::Sha256::compute(tx.hashOfTransaction().getBytes().toBytes());
+    secp256k1_ecdsa_recoverable_signature recoverable_signature;
+    if (secp256k1_ecdsa_recoverable_signature_parse_compact(
+          context.get(), &recoverable_signature, sig_data.getData(), static_cast<int>(sig_data[sig_data.size() - 1])) ==
+        0) {
+        return false;
+    }
+    secp256k1_pubkey pubkey;
+    if (secp256k1_ecdsa_recover(context.get(), &pubkey, &recoverable_signature, hash.getBytes().getData()) == 0) {
+        return false;
+    }
+    base::Secp256PrivateKey::PublicKey output;
+    std::size_t output_size = output.size();
+    secp256k1_ec_pubkey_serialize(context.get(), output.getData(), &output_size, &pubkey, SECP256K1_EC_UNCOMPRESSED);
+    return tx.getFrom() == lk::Address(output);
+}
+
+
+void measure(const std::string& name, std::size_t signatures_number, const std::function<bool()>& run)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const bool is_valid = run();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << signatures_number / seconds << " verifications/s" << std::defaultfloat
+              << (is_valid ? "" : "  (INVALID SIGNATURES FOUND)") << '\n';
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    try {
+        base::initLog(base::Sink::FILE);
+
+        base::ProgramOptionsParser parser;
+        parser.addOption<std::uint64_t>("count,n", 2000, "Number of signed transactions");
+        parser.addOption<std::uint64_t>(
+          "threads,t", std::thread::hardware_concurrency(), "Number of threads of the signature verifier");
+        parser.process(argc, argv);
+        if (parser.hasOption("help")) {
+            std::cout << parser.helpMessage() << std::endl;
+            return base::config::EXIT_OK;
+        }
+        const auto count = parser.getValue<std::uint64_t>("count");
+        const auto threads = parser.getValue<std::uint64_t>("threads");
+
+        base::Secp256PrivateKey key;
+        lk::Address from{ key.toPublicKey() };
+        lk::Address to{ base::Secp256PrivateKey().toPublicKey() };
+        lk::TransactionsSet txs;
+        std::vector<const lk::Transaction*> txs_pointers;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            lk::Transaction tx{ from, to, i + 1, 10, base::Time::now(), base::Bytes{} };
+            tx.sign(key);
+            txs.add(tx);
+        }
+        for (const auto& tx : txs) {
+            txs_pointers.push_back(&tx);
+        }
+
+        measure("context per signature", count, [&txs] {
+            bool is_valid = true;
+            for (const auto& tx : txs) {
+                is_valid = checkSignWithNewContext(tx) && is_valid;
+            }
+            return is_valid;
+        });
+        measure("shared context", count, [&txs] {
+            bool is_valid = true;
+            for (const auto& tx : txs) {
+                is_valid = tx.checkSign() && is_valid;
+            }
+            return is_valid;
+        });
+        measure("batch", count, [&txs_pointers] {
+            bool is_valid = true;
+            for (bool is_sign_valid : lk::Transaction::checkSigns(txs_pointers)) {
+                is_valid = is_sign_valid && is_valid;
+            }
+            return is_valid;
+        });
+        measure("batch on " + std::to_string(threads) + " threads", count, [&txs, threads, count] {
+            lk::SignatureVerifier verifier{ threads, count };
+            return verifier.verifyAll(txs);
+        });
+        return base::config::EXIT_OK;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return base::config::EXIT_FAIL;
+    }
+}
@@ -0,0 +1,166 @@
+#include "core/managers.hpp"
+
+#include "base/config.hpp"
+#include "base/log.hpp"
+#include "base/program_options.hpp"
+#include "base/time.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Applies blocks of transfers to the accounts state the same way the core does for a transaction without a contract:
+ * the block is checked against balances, then every transaction is registered, transferred in its own commit and
+ * its fee is paid. Transfers to a contract show that its storage isn't copied with the account. Storage is read and
+ * written the way the virtual machine host does on SLOAD and SSTORE.
+ */
+
+namespace
+{
+
+lk::Address makeAddress(std::uint64_t index)
+{
+    // accounts are made from public keys, so their addresses look random
+    const auto digest = base::Sha256::compute(base::Bytes(reinterpret_cast<const base::Byte*>(&index), sizeof(index)));
+    return lk::Address{ base::Bytes(digest.getBytes().getData(), lk::Address::LENGTH_IN_BYTES) };
+}
+
+
+template<typename F>
+void measure(const std::string& name, std::size_t operations_number, F&& run)
+{
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << elapsed / operations_number << " ns/op" << std::defaultfloat << '\n';
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    try {
+        base::initLog(base::Sink::FILE);
+
+        base::ProgramOptionsParser parser;
+        parser.addOption<std::uint64_t>("accounts,a", 100'000, "Number of accounts in the state");
+        parser.addOption<std::uint64_t>("transactions,n", 10'000, "Number of transfers in a block");
+        parser.addOption<std::uint64_t>("blocks,b", 10, "Number of applied blocks");
+        parser.addOption<std::uint64_t>("storage,s", 10'000, "Number of storage values of the contract");
+        parser.process(argc, argv);
+        if (parser.hasOption("help")) {
+            std::cout << parser.helpMessage() << std::endl;
+            return base::config::EXIT_OK;
+        }
+        const auto accounts_number = std::max<std::uint64_t>(parser.getValue<std::uint64_t>("accounts"), 1);
+        const auto transactions_number = parser.getValue<std::uint64_t>("transactions");
+        const auto blocks_number = std::max<std::uint64_t>(parser.getValue<std::uint64_t>("blocks"), 1);
+        const auto storage_size = parser.getValue<std::uint64_t>("storage");
+
+        std::vector<lk::Address> addresses;
+        addresses.reserve(accounts_number);
+        for (std::uint64_t i = 0; i < accounts_number; ++i) {
+            addresses.push_back(makeAddress(i));
+        }
+
+        lk::StateManager state_manager;
+        measure("create account", accounts_number, [&] {
+            for (const auto& address : addresses) {
+                state_manager.applyBlockEmission(address, 1'000'000'000);
+            }
+        });
+
+        std::mt19937_64 random{ 42 };
+        std::vector<lk::TransactionsSet> blocks(blocks_number);
+        for (auto& txs : blocks) {
+            for (std::uint64_t i = 0; i < transactions_number; ++i) {
+                const auto& from = addresses[random() % accounts_number];
+                const auto& to = addresses[random() % accounts_number];
+                txs.add(lk::Transaction{ from, to, random() % 1000 + 1, 10, base::Time::now(), base::Bytes{} });
+            }
+        }
+        const auto& coinbase = addresses.front();
+
+        measure("check block, per transaction", blocks_number * transactions_number, [&] {
+            for (const auto& txs : blocks) {
+                if (!state_manager.checkTransactionsSet(txs)) {
+                    throw std::runtime_error("block has not enough balance");
+                }
+            }
+        });
+
+        measure("apply transfer", blocks_number * transactions_number, [&] {
+            for (const auto& txs : blocks) {
+                for (const auto& tx : txs) {
+                    state_manager.registerTransaction(tx.getFrom());
+                    auto commit = state_manager.createCommit();
+                    if (commit.tryTransferMoney(tx.getFrom(), tx.getTo(), tx.getAmount())) {
+                        state_manager.applyCommit(std::move(commit));
+                    }
+                    state_manager.payFee(tx.getFrom(), coinbase, tx.getFee());
+                }
+            }
+        });
+
+        std::vector<lk::StorageSlot> storage_keys;
+        storage_keys.reserve(storage_size);
+        for (std::uint64_t i = 0; i < storage_size; ++i) {
+            // keys of mappings are digests
+            const auto data = base::Bytes(reinterpret_cast<const base::Byte*>(&i), sizeof(i));
+            storage_keys.push_back(base::Sha256::compute(data).getBytes());
+        }
+
+        auto contract_commit = state_manager.createCommit();
+        const auto contract_address =
+          contract_commit.createContractAccount(coinbase, base::Sha256::compute(base::Bytes("contract code")));
+        for (const auto& key : storage_keys) {
+            contract_commit.setStorageValue(contract_address, key, lk::StorageSlot{});
+        }
+        state_manager.applyCommit(std::move(contract_commit));
+
+        measure("storage write", storage_size, [&] {
+            auto commit = state_manager.createCommit();
+            for (const auto& key : storage_keys) {
+                if (commit.findStorageValue(contract_address, key) != key) {
+                    commit.setStorageValue(contract_address, key, key);
+                }
+            }
+            state_manager.applyCommit(std::move(commit));
+        });
+
+        std::size_t read_values_checksum = 0;
+        measure("storage read", storage_size, [&] {
+            auto commit = state_manager.createCommit();
+            for (const auto& key : storage_keys) {
+                read_values_checksum += commit.getStorageValue(contract_address, key)[0];
+            }
+        });
+
+        measure("transfer to contract", transactions_number, [&] {
+            for (std::uint64_t i = 0; i < transactions_number; ++i) {
+                auto commit = state_manager.createCommit();
+                if (commit.tryTransferMoney(addresses[i % accounts_number], contract_address, 1)) {
+                    state_manager.applyCommit(std::move(commit));
+                }
+            }
+        });
+
+        lk::Balance total;
+        measure("get account info", accounts_number, [&] {
+            for (const auto& address : addresses) {
+                total += state_manager.getAccountInfo(address).balance;
+            }
+        });
+        std::cout << "total balance: " << total << ", storage checksum: " << read_values_checksum << '\n';
+        return base::config::EXIT_OK;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return base::config::EXIT_FAIL;
+    }
+}
@@ -35,12 +35,12 @@ class AccountType(enum.Enum):
 
 
 class AccountInfo:
-    def __init__(self, account_type: AccountType, address: str, balance: int, nonce: int, tx_hashes: list):
+    def __init__(self, account_type: AccountType, address: str, balance: int, nonce: int, transactions_count: int):
         self.account_type = account_type
         self.address = address
         self.balance = balance
         self.nonce = nonce
-        self.tx_hashes = tx_hashes
+        self.transactions_count = transactions_count
 
 
 class TransactionStatusCode(enum.Enum):
@@ -129,10 +129,8 @@ class _GetAccountInfoParser:
         balance = int(result["balance"])
         nonce = result["nonce"]
         account_type = AccountType(result['type'])
-        txs_hashes = list()
-        for item in result['transaction_hashes']:
-            txs_hashes.append(_base64_to_hex(item))
-        return AccountInfo(account_type, address, balance, nonce, txs_hashes)
+        transactions_count = result['transactions_count']
+        return AccountInfo(account_type, address, balance, nonce, transactions_count)
 
 
 class _TransactionStatusParser:
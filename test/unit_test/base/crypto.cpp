@@ -82,6 +82,27 @@ BOOST_AUTO_TEST_CASE(secp256_sign_verify)
 }
 
 
+BOOST_AUTO_TEST_CASE(secp256_decode_many_signatures)
+{
+    auto private_key1 = base::Secp256PrivateKey{};
+    auto private_key2 = base::Secp256PrivateKey{};
+    auto bytes1 = base::Sha256::compute(base::Bytes("111")).getBytes().toBytes();
+    auto bytes2 = base::Sha256::compute(base::Bytes("222")).getBytes().toBytes();
+
+    auto broken_signature = private_key1.sign(bytes1);
+    broken_signature[broken_signature.size() - 1] = 7; // recovery id must be below 4
+
+    auto public_keys = base::Secp256PrivateKey::decodeSignaturesToPublicKeys(
+      { private_key1.sign(bytes1), private_key2.sign(bytes2), broken_signature }, { bytes1, bytes2, bytes1 });
+    BOOST_REQUIRE_EQUAL(public_keys.size(), 3);
+    BOOST_REQUIRE(public_keys[0]);
+    BOOST_CHECK_EQUAL(public_keys[0]->toBytes(), private_key1.toPublicKey().toBytes());
+    BOOST_REQUIRE(public_keys[1]);
+    BOOST_CHECK_EQUAL(public_keys[1]->toBytes(), private_key2.toPublicKey().toBytes());
+    BOOST_CHECK(!public_keys[2]);
+}
+
+
 BOOST_AUTO_TEST_CASE(secp256_save_load)
 {
     auto private_key1 = base::Secp256PrivateKey{};
@@ -3,6 +3,11 @@
 #include "base/database.hpp"
 #include "base/error.hpp"
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(data_base_test_1)
 {
     std::filesystem::path path_to_data_base_folder("local_test_base");
@@ -236,4 +241,128 @@ BOOST_AUTO_TEST_CASE(data_base_with_long_path)
     BOOST_CHECK_EQUAL(data_base2.get(key1).value().toString(), bytes1.toString());
 
     std::filesystem::remove_all(path_to_data_base_folder);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(data_base_write_batch)
+{
+    std::filesystem::path path_to_data_base_folder("local_test_base");
+
+    base::Bytes bytes1("first value");
+    base::Bytes bytes2("second value");
+    base::Bytes key1("first key");
+    base::Bytes key2("second key");
+    base::Bytes key3("removed key");
+
+    auto data_base = base::createClearDatabaseInstance(path_to_data_base_folder);
+    data_base.put(key3, bytes1);
+
+    base::Database::WriteBatch batch;
+    BOOST_CHECK(batch.isEmpty());
+    batch.put(key1, bytes1);
+    batch.put(key2, bytes2);
+    batch.remove(key3);
+    BOOST_CHECK_EQUAL(batch.size(), 3);
+
+    BOOST_CHECK(!data_base.exists(key1));
+    data_base.write(std::move(batch));
+
+    BOOST_CHECK_EQUAL(data_base.get(key1).value().toString(), bytes1.toString());
+    BOOST_CHECK_EQUAL(data_base.get(key2).value().toString(), bytes2.toString());
+    BOOST_CHECK(!data_base.exists(key3));
+
+    std::filesystem::remove_all(path_to_data_base_folder);
+}
+
+
+BOOST_AUTO_TEST_CASE(data_base_group_commit_from_several_threads)
+{
+    std::filesystem::path path_to_data_base_folder("local_test_base");
+
+    constexpr std::size_t THREADS_COUNT = 4;
+    constexpr std::size_t WRITES_PER_THREAD = 50;
+    {
+        auto data_base = base::createClearDatabaseInstance(path_to_data_base_folder);
+        data_base.enableGroupCommit();
+
+        std::vector<std::thread> writers;
+        for (std::size_t t = 0; t < THREADS_COUNT; ++t) {
+            writers.emplace_back([&data_base, t] {
+                for (std::size_t i = 0; i < WRITES_PER_THREAD; ++i) {
+                    base::Database::WriteBatch batch;
+                    batch.put(base::Bytes("key " + std::to_string(t) + " " + std::to_string(i)),
+                              base::Bytes(std::to_string(i)));
+                    data_base.write(std::move(batch));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        BOOST_CHECK(data_base.getCommittedGroupsCount() <= THREADS_COUNT * WRITES_PER_THREAD);
+    }
+
+    auto data_base2 = base::createDefaultDatabaseInstance(path_to_data_base_folder);
+    for (std::size_t t = 0; t < THREADS_COUNT; ++t) {
+        for (std::size_t i = 0; i < WRITES_PER_THREAD; ++i) {
+            auto value = data_base2.get(base::Bytes("key " + std::to_string(t) + " " + std::to_string(i)));
+            BOOST_CHECK(value);
+            BOOST_CHECK_EQUAL(value.value().toString(), std::to_string(i));
+        }
+    }
+
+    std::filesystem::remove_all(path_to_data_base_folder);
+}
+
+
+BOOST_AUTO_TEST_CASE(data_base_group_commit_merges_concurrent_writes)
+{
+    std::filesystem::path path_to_data_base_folder("local_test_base");
+
+    constexpr std::size_t THREADS_COUNT = 8;
+    constexpr std::size_t WRITES_PER_THREAD = 20;
+    {
+        auto data_base = base::createClearDatabaseInstance(path_to_data_base_folder);
+        data_base.enableGroupCommit();
+
+        // sequential writes never wait for each other, so every one of them is a separate group
+        for (std::size_t i = 0; i < WRITES_PER_THREAD; ++i) {
+            base::Database::WriteBatch batch;
+            batch.put(base::Bytes("sequential " + std::to_string(i)), base::Bytes(std::to_string(i)));
+            data_base.write(std::move(batch));
+        }
+        BOOST_CHECK_EQUAL(data_base.getCommittedGroupsCount(), WRITES_PER_THREAD);
+
+        // writers that come while a synced write is in progress are merged into the next one
+        std::atomic<std::size_t> ready_writers{ 0 };
+        std::vector<std::thread> writers;
+        for (std::size_t t = 0; t < THREADS_COUNT; ++t) {
+            writers.emplace_back([&data_base, &ready_writers, t] {
+                ++ready_writers;
+                while (ready_writers < THREADS_COUNT) {
+                    std::this_thread::yield();
+                }
+                for (std::size_t i = 0; i < WRITES_PER_THREAD; ++i) {
+                    base::Database::WriteBatch batch;
+                    batch.put(base::Bytes("key " + std::to_string(t) + " " + std::to_string(i)),
+                              base::Bytes(std::to_string(i)));
+                    data_base.write(std::move(batch));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+
+        const auto concurrent_groups_count = data_base.getCommittedGroupsCount() - WRITES_PER_THREAD;
+        BOOST_CHECK(concurrent_groups_count > 0);
+        BOOST_CHECK(concurrent_groups_count < THREADS_COUNT * WRITES_PER_THREAD);
+
+        for (std::size_t t = 0; t < THREADS_COUNT; ++t) {
+            for (std::size_t i = 0; i < WRITES_PER_THREAD; ++i) {
+                BOOST_CHECK(data_base.exists(base::Bytes("key " + std::to_string(t) + " " + std::to_string(i))));
+            }
+        }
+    }
+
+    std::filesystem::remove_all(path_to_data_base_folder);
+}
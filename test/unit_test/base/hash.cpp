@@ -2,6 +2,7 @@
 
 #include "base/bytes.hpp"
 #include "base/hash.hpp"
+#include "base/sha256_kernels.hpp"
 
 
 BOOST_AUTO_TEST_CASE(sha256_hash)
@@ -102,6 +103,120 @@ BOOST_AUTO_TEST_CASE(sha256_multiple_serialization)
 }
 
 
+namespace
+{
+
+base::Bytes makeMessage(std::size_t length, std::size_t seed)
+{
+    base::Bytes ret(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        ret[i] = static_cast<base::Byte>(i * 31 + seed * 7 + (i >> 3));
+    }
+    return ret;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(sha256_every_kernel_matches_openssl)
+{
+    // lengths around the padding boundaries: 55/56 bytes and whole blocks
+    std::vector<base::Bytes> messages;
+    std::vector<const base::Byte*> data;
+    std::vector<std::size_t> lengths;
+    for (std::size_t length = 0; length <= 200; ++length) {
+        messages.push_back(makeMessage(length, length));
+    }
+    for (const auto& message : messages) {
+        data.push_back(message.getData());
+        lengths.push_back(message.size());
+    }
+
+    BOOST_CHECK(!base::impl::getSupportedSha256Kernels().empty());
+    for (const auto* kernel : base::impl::getSupportedSha256Kernels()) {
+        BOOST_TEST_MESSAGE("checking SHA-256 kernel " << kernel->name);
+        std::vector<base::FixedBytes<base::Sha256::LENGTH>> digests(messages.size());
+        base::impl::sha256FinalizeMany(*kernel,
+                                       base::impl::SHA256_INITIAL_STATE,
+                                       0,
+                                       nullptr,
+                                       0,
+                                       data.data(),
+                                       lengths.data(),
+                                       messages.size(),
+                                       digests.data());
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            BOOST_CHECK_EQUAL(base::Sha256(digests[i]), base::Sha256::compute(messages[i]));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(sha256_compute_many_matches_compute)
+{
+    for (std::size_t count : { 0, 1, 7, 8, 9, 17 }) {
+        std::vector<base::Bytes> messages;
+        for (std::size_t i = 0; i < count; ++i) {
+            messages.push_back(makeMessage((i * 37) % 150, i));
+        }
+        const auto hashes = base::Sha256::computeMany(messages);
+        BOOST_REQUIRE_EQUAL(hashes.size(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(hashes[i], base::Sha256::compute(messages[i]));
+        }
+    }
+
+    const std::vector<base::Bytes> same_length(16, base::Bytes("likelib"));
+    for (const auto& hash : base::Sha256::computeMany(same_length)) {
+        BOOST_CHECK_EQUAL(hash.toHex(), base::Sha256::compute(base::Bytes("likelib")).toHex());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(sha256_builder_matches_compute)
+{
+    for (std::size_t length = 0; length <= 300; length += 13) {
+        const auto message = makeMessage(length, 1);
+        for (std::size_t first_part = 0; first_part <= length; first_part += 29) {
+            base::Sha256Builder builder;
+            builder.update(message.getData(), first_part);
+            builder.update(message.getData() + first_part, length - first_part);
+            BOOST_CHECK_EQUAL(builder.finalize(), base::Sha256::compute(message));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(sha256_builder_finalize_many_matches_compute)
+{
+    constexpr std::size_t COUNT = 11;
+    for (std::size_t prefix_length : { 0, 32, 63, 64, 96, 130 }) {
+        for (std::size_t suffix_length : { 0, 8, 23, 64, 70 }) {
+            const auto prefix = makeMessage(prefix_length, 2);
+            base::Sha256Builder builder;
+            builder.update(prefix);
+
+            std::vector<base::Bytes> suffixes;
+            std::vector<const base::Byte*> data;
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                suffixes.push_back(makeMessage(suffix_length, i + 3));
+            }
+            for (const auto& suffix : suffixes) {
+                data.push_back(suffix.getData());
+            }
+
+            std::vector<base::FixedBytes<base::Sha256::LENGTH>> digests(COUNT);
+            builder.finalizeMany(data.data(), suffix_length, COUNT, digests.data());
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                BOOST_CHECK_EQUAL(base::Sha256(digests[i]), base::Sha256::compute(prefix + suffixes[i]));
+            }
+            // the builder itself is untouched
+            BOOST_CHECK_EQUAL(builder.finalize(), base::Sha256::compute(prefix));
+        }
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(sha1_hash)
 {
     auto sha1_1 = base::Sha1::compute(base::Bytes{ 0x4c, 0x49, 0x4b, 0x45, 0x4c, 0x49, 0x42, 0x9, 0x32, 0x2e, 0x30 });
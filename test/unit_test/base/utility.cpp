@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+
+#include "base/error.hpp"
+#include "base/utility.hpp"
+
+#include <string>
+
+BOOST_AUTO_TEST_CASE(lru_cache_put_and_find)
+{
+    base::LruCache<int, std::string> cache(3);
+    cache.put(1, "one");
+    cache.put(2, "two");
+
+    BOOST_CHECK(cache.size() == 2);
+    BOOST_CHECK(cache.capacity() == 3);
+    BOOST_CHECK(cache.find(1).value() == "one");
+    BOOST_CHECK(cache.find(2).value() == "two");
+    BOOST_CHECK(!cache.find(3));
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_evicts_least_recently_used)
+{
+    base::LruCache<int, std::string> cache(2);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    BOOST_CHECK(cache.find(1)); // now 2 is least recently used
+    cache.put(3, "three");
+
+    BOOST_CHECK(cache.size() == 2);
+    BOOST_CHECK(cache.find(1));
+    BOOST_CHECK(!cache.find(2));
+    BOOST_CHECK(cache.find(3));
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_put_overrides_value)
+{
+    base::LruCache<int, std::string> cache(2);
+    cache.put(1, "one");
+    cache.put(1, "uno");
+
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.find(1).value() == "uno");
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_remove_and_clear)
+{
+    base::LruCache<int, std::string> cache(4);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    cache.remove(2);
+    BOOST_CHECK(cache.size() == 2);
+    BOOST_CHECK(!cache.find(2));
+
+    cache.clear();
+    BOOST_CHECK(cache.size() == 0);
+    BOOST_CHECK(!cache.find(1));
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_stats)
+{
+    base::LruCache<int, std::string> cache(2);
+    cache.put(1, "one");
+    cache.find(1);
+    cache.find(1);
+    cache.find(2);
+
+    auto stats = cache.getStats();
+    BOOST_CHECK(stats.hits == 2);
+    BOOST_CHECK(stats.misses == 1);
+    BOOST_CHECK(stats.size == 1);
+    BOOST_CHECK(stats.weight == 1);
+    BOOST_CHECK(stats.capacity == 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_weighted_entries)
+{
+    base::LruCache<int, std::string> cache(10);
+    cache.put(1, "one", 4);
+    cache.put(2, "two", 4);
+    cache.find(1);
+    cache.put(3, "three", 4);
+    BOOST_CHECK(cache.find(1));
+    BOOST_CHECK(!cache.find(2));
+    BOOST_CHECK(cache.find(3));
+    BOOST_CHECK(cache.getStats().weight == 8);
+
+    cache.put(1, "one", 1);
+    BOOST_CHECK(cache.getStats().weight == 5);
+    cache.remove(3);
+    BOOST_CHECK(cache.getStats().weight == 1);
+
+    // an entry heavier than the capacity replaces all others, but is still kept
+    cache.put(4, "four", 20);
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.find(4));
+    BOOST_CHECK(cache.getStats().weight == 20);
+}
+
+
+BOOST_AUTO_TEST_CASE(lru_cache_zero_capacity)
+{
+    BOOST_CHECK_THROW((base::LruCache<int, std::string>(0)), base::InvalidArgument);
+}
@@ -1,3 +1,99 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/block.hpp"
+
+namespace
+{
+
+lk::MutableBlock getTestMutableBlock()
+{
+    lk::Address from{ base::Bytes(lk::Address::LENGTH_IN_BYTES) };
+    lk::Address to{ base::Bytes("to address bytes!!!!") };
+    lk::TransactionsSet txs;
+    txs.add(lk::Transaction{ from, to, 12398, 10, base::Time(1583789617), base::Bytes{} });
+    txs.add(lk::Transaction{ to, from, 5825285, 20, base::Time(1583789618), base::Bytes("contract code") });
+
+    lk::BlockBuilder builder;
+    builder.setDepth(119);
+    builder.setNonce(6706744);
+    builder.setPrevBlockHash(base::Sha256::compute(base::Bytes("previous block")));
+    builder.setTimestamp(base::Time(1583789619));
+    builder.setCoinbase(to);
+    builder.setTransactionsSet(std::move(txs));
+    return std::move(builder).buildMutable();
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(pow_header_hash_is_block_hash)
+{
+    auto mutable_block = getTestMutableBlock();
+    auto immutable_block = lk::BlockBuilder{ mutable_block }.buildImmutable();
+
+    lk::PowHeader header{ mutable_block };
+    BOOST_CHECK(header.getBytes().size() == lk::PowHeader::SIZE);
+    BOOST_CHECK(header.computeHash() == immutable_block.getHash());
+    BOOST_CHECK(lk::PowHeader::computeHash(header.getPrefixHashingState(), mutable_block.getNonce()) ==
+                immutable_block.getHash());
+}
+
+
+BOOST_AUTO_TEST_CASE(pow_header_prefix_state_is_reusable_for_any_nonce)
+{
+    auto mutable_block = getTestMutableBlock();
+    auto prefix_hashing_state = lk::PowHeader{ mutable_block }.getPrefixHashingState();
+
+    for (lk::NonceInt nonce = 0; nonce < 100; ++nonce) {
+        mutable_block.setNonce(nonce);
+        auto immutable_block = lk::BlockBuilder{ mutable_block }.buildImmutable();
+        BOOST_CHECK(lk::PowHeader::computeHash(prefix_hashing_state, nonce) == immutable_block.getHash());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(pow_header_batch_hashes_match_single_hashes)
+{
+    auto mutable_block = getTestMutableBlock();
+    auto prefix_hashing_state = lk::PowHeader{ mutable_block }.getPrefixHashingState();
+
+    // the last batch wraps the nonce around
+    for (lk::NonceInt first_nonce : { lk::NonceInt{ 0 }, lk::NonceInt{ 123456 }, lk::NonceInt(-3) }) {
+        lk::PowHeader::HashesBatch hashes;
+        lk::PowHeader::computeHashes(prefix_hashing_state, first_nonce, hashes);
+        for (std::size_t i = 0; i < hashes.size(); ++i) {
+            const lk::NonceInt nonce = first_nonce + i;
+            BOOST_CHECK(hashes[i] == lk::PowHeader::computeHash(prefix_hashing_state, nonce).getBytes());
+            mutable_block.setNonce(nonce);
+            BOOST_CHECK(hashes[i] == lk::BlockBuilder{ mutable_block }.buildImmutable().getHash().getBytes());
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(pow_header_commits_to_transactions)
+{
+    auto mutable_block = getTestMutableBlock();
+    auto hash = lk::PowHeader{ mutable_block }.computeHash();
+
+    auto txs = mutable_block.getTransactions();
+    txs.add(lk::Transaction{ lk::Address::null(), mutable_block.getCoinbase(), 1, 0, base::Time(1), base::Bytes{} });
+    mutable_block.setTransactions(std::move(txs));
+    BOOST_CHECK(lk::PowHeader{ mutable_block }.computeHash() != hash);
+}
+
+
+BOOST_AUTO_TEST_CASE(block_copies_share_encoding)
+{
+    auto block = lk::BlockBuilder{ getTestMutableBlock() }.buildImmutable();
+    auto block_copy = block;
+
+    BOOST_CHECK(&block_copy.getSerialized() == &block.getSerialized());
+    BOOST_CHECK(base::toBytes(block_copy) == block.getSerialized());
+    BOOST_CHECK(base::fromBytes<lk::ImmutableBlock>(block.getSerialized()).getHash() == block.getHash());
+}
+
+
 //#include <boost/test/unit_test.hpp>
 //
 //#include "core/block.hpp"
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/block_template.hpp"
+
+#include <list>
+#include <vector>
+
+namespace
+{
+
+lk::Transaction makeTransaction(lk::Fee fee, std::uint32_t timestamp)
+{
+    lk::Address from{ base::Bytes("from address bytes!!") };
+    lk::Address to{ base::Bytes("to address bytes!!!!") };
+    return lk::Transaction{ from, to, 100, fee, base::Time(timestamp), base::Bytes{} };
+}
+
+
+std::vector<lk::Fee> getFees(const lk::TransactionsSet& txs)
+{
+    std::vector<lk::Fee> ret;
+    for (const auto& tx : txs) {
+        ret.push_back(tx.getFee());
+    }
+    return ret;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(block_template_keeps_best_by_fee_in_arrival_order)
+{
+    lk::BlockTemplate block_template{ 3 };
+    std::list<lk::Transaction> txs; // the template doesn't own them
+    std::uint32_t timestamp = 1;
+    for (lk::Fee fee : { 5, 1, 7, 3, 6 }) {
+        block_template.add(txs.emplace_back(makeTransaction(fee, timestamp++)));
+    }
+
+    BOOST_CHECK_EQUAL(block_template.size(), 5);
+    BOOST_CHECK_EQUAL(block_template.getSelectedNumber(), 3);
+    BOOST_CHECK(block_template.getFeeValue() == lk::Balance{ 18 });
+    BOOST_CHECK(getFees(block_template.getTransactions()) == (std::vector<lk::Fee>{ 5, 7, 6 }));
+}
+
+
+BOOST_AUTO_TEST_CASE(block_template_promotes_candidates_on_removal)
+{
+    lk::BlockTemplate block_template{ 2 };
+    auto tx1 = makeTransaction(10, 1);
+    auto tx2 = makeTransaction(20, 2);
+    auto tx3 = makeTransaction(15, 3);
+    auto tx4 = makeTransaction(15, 4);
+    block_template.add(tx1);
+    block_template.add(tx2);
+    block_template.add(tx3);
+    block_template.add(tx4);
+    BOOST_CHECK(getFees(block_template.getTransactions()) == (std::vector<lk::Fee>{ 20, 15 }));
+
+    // the earlier of equal fees is selected
+    lk::TransactionsSet mined;
+    mined.add(tx2);
+    mined.add(tx3);
+    block_template.remove(mined);
+    BOOST_CHECK_EQUAL(block_template.size(), 2);
+    BOOST_CHECK(block_template.getTransactions().find(tx4));
+    BOOST_CHECK(block_template.getTransactions().find(tx1));
+    BOOST_CHECK(block_template.getFeeValue() == lk::Balance{ 25 });
+
+    block_template.remove(tx4);
+    block_template.remove(tx4);
+    BOOST_CHECK_EQUAL(block_template.getSelectedNumber(), 1);
+    BOOST_CHECK(block_template.getFeeValue() == lk::Balance{ 10 });
+}
+
+
+BOOST_AUTO_TEST_CASE(block_template_ignores_duplicates)
+{
+    lk::BlockTemplate block_template{ 2 };
+    auto tx = makeTransaction(10, 1);
+    block_template.add(tx);
+    block_template.add(tx);
+    BOOST_CHECK_EQUAL(block_template.size(), 1);
+    BOOST_CHECK(block_template.getFeeValue() == lk::Balance{ 10 });
+    BOOST_CHECK_EQUAL(block_template.getTransactions().size(), 1);
+}
@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/address_table.hpp"
+#include "core/bytes_table.hpp"
+
+#include <map>
+#include <random>
+
+namespace
+{
+
+lk::Address makeAddress(std::uint32_t index)
+{
+    // only the middle bytes differ, so all addresses have the same head and tail
+    base::Bytes raw(lk::Address::LENGTH_IN_BYTES);
+    for (std::size_t i = 0; i < sizeof(index); ++i) {
+        raw[8 + i] = static_cast<base::Byte>(index >> (8 * i));
+    }
+    return lk::Address{ raw };
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(address_table_insert_find)
+{
+    lk::AddressTable<int> table;
+    BOOST_CHECK(table.isEmpty());
+    BOOST_CHECK(!table.find(makeAddress(1)));
+
+    auto [value, is_inserted] = table.insert(makeAddress(1), 10);
+    BOOST_CHECK(is_inserted);
+    BOOST_CHECK_EQUAL(*value, 10);
+
+    std::tie(value, is_inserted) = table.insert(makeAddress(1), 20);
+    BOOST_CHECK(!is_inserted);
+    BOOST_CHECK_EQUAL(*value, 10);
+
+    BOOST_CHECK_EQUAL(table.insertOrAssign(makeAddress(1), 30), 30);
+    BOOST_CHECK_EQUAL(table.insertOrAssign(makeAddress(2), 40), 40);
+    BOOST_CHECK_EQUAL(table.size(), 2);
+    BOOST_CHECK_EQUAL(*table.find(makeAddress(1)), 30);
+    BOOST_CHECK(table.contains(makeAddress(2)));
+    BOOST_CHECK(!table.contains(makeAddress(3)));
+}
+
+
+BOOST_AUTO_TEST_CASE(address_table_matches_map)
+{
+    lk::AddressTable<std::uint32_t> table;
+    std::map<lk::Address, std::uint32_t> expected;
+    std::mt19937 random{ 42 };
+    for (int i = 0; i < 20000; ++i) {
+        const auto index = random() % 3000;
+        const auto address = makeAddress(index);
+        if (random() % 3 == 0) {
+            BOOST_CHECK_EQUAL(table.erase(address), expected.erase(address) == 1);
+        }
+        else {
+            table.insertOrAssign(address, index + i);
+            expected[address] = index + i;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(table.size(), expected.size());
+    for (std::uint32_t index = 0; index < 3000; ++index) {
+        const auto address = makeAddress(index);
+        const auto it = expected.find(address);
+        const auto value = table.find(address);
+        BOOST_CHECK_EQUAL(value != nullptr, it != expected.end());
+        if (value && it != expected.end()) {
+            BOOST_CHECK_EQUAL(*value, it->second);
+        }
+    }
+
+    std::size_t visited = 0;
+    table.forEach([&](const lk::Address& address, std::uint32_t value) {
+        BOOST_CHECK_EQUAL(expected.at(address), value);
+        ++visited;
+    });
+    BOOST_CHECK_EQUAL(visited, expected.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(address_table_copy_and_move)
+{
+    lk::AddressTable<std::string> table;
+    table.insert(makeAddress(1), "one");
+    table.insert(makeAddress(2), "two");
+
+    auto copy = table;
+    copy.insertOrAssign(makeAddress(1), "changed");
+    BOOST_CHECK_EQUAL(*table.find(makeAddress(1)), "one");
+
+    auto moved = std::move(table);
+    BOOST_CHECK_EQUAL(moved.size(), 2);
+    BOOST_CHECK_EQUAL(*moved.find(makeAddress(2)), "two");
+    BOOST_CHECK(table.isEmpty());
+    BOOST_CHECK(!table.find(makeAddress(2)));
+    table.insert(makeAddress(3), "three");
+    BOOST_CHECK_EQUAL(table.size(), 1);
+
+    moved.clear();
+    BOOST_CHECK(moved.isEmpty());
+    BOOST_CHECK(!moved.erase(makeAddress(1)));
+}
+
+
+BOOST_AUTO_TEST_CASE(bytes_table_small_integer_keys)
+{
+    // storage slots of a contract are mostly small integers: 32 bytes with only the last ones set
+    auto make_slot = [](std::uint32_t index) {
+        base::FixedBytes<32> slot;
+        for (std::size_t i = 0; i < sizeof(index); ++i) {
+            slot[31 - i] = static_cast<base::Byte>(index >> (8 * i));
+        }
+        return slot;
+    };
+
+    lk::BytesTable<base::FixedBytes<32>, base::FixedBytes<32>> table;
+    for (std::uint32_t index = 0; index < 1000; ++index) {
+        table.insert(make_slot(index), make_slot(index * 2));
+    }
+    BOOST_CHECK(table.erase(make_slot(0)));
+    BOOST_CHECK_EQUAL(table.size(), 999);
+    BOOST_CHECK(!table.contains(make_slot(0)));
+    for (std::uint32_t index = 1; index < 1000; ++index) {
+        const auto value = table.find(make_slot(index));
+        BOOST_CHECK(value && *value == make_slot(index * 2));
+    }
+}
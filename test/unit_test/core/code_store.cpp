@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/code_store.hpp"
+
+#include "base/error.hpp"
+
+#include <map>
+
+namespace
+{
+
+class MapCodeStorage : public lk::ICodeStorage
+{
+  public:
+    std::optional<base::Bytes> findContractCode(const base::Sha256& code_hash) const override
+    {
+        ++reads_count;
+        if (auto it = codes.find(code_hash); it != codes.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    std::map<base::Sha256, base::Bytes> codes;
+    mutable std::size_t reads_count{ 0 };
+};
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(code_store_shares_code_and_drops_unreferenced)
+{
+    MapCodeStorage storage;
+    lk::CodeStore code_store;
+    code_store.setStorage(storage);
+
+    const base::Bytes code{ "runtime" };
+    const auto code_hash = base::Sha256::compute(code);
+    code_store.addReference(code_hash, std::make_shared<const base::Bytes>(code));
+    code_store.addReference(code_hash, std::make_shared<const base::Bytes>(code));
+    BOOST_CHECK(storage.codes.empty());
+
+    // new code is handed out once to be stored by the caller
+    auto new_code = code_store.takeNewCode();
+    BOOST_CHECK_EQUAL(new_code.size(), 1);
+    BOOST_CHECK(new_code[0].first == code_hash);
+    BOOST_CHECK(*new_code[0].second == code);
+    BOOST_CHECK(code_store.takeNewCode().empty());
+    storage.codes.emplace(code_hash, *new_code[0].second);
+    BOOST_CHECK_EQUAL(code_store.size(), 1);
+    BOOST_CHECK(code_store.find(code_hash) == code_store.find(code_hash));
+    BOOST_CHECK(*code_store.find(code_hash) == code);
+    BOOST_CHECK(code_store.find(base::Sha256::null())->isEmpty());
+
+    code_store.removeReference(code_hash);
+    BOOST_CHECK_EQUAL(code_store.size(), 1);
+    code_store.removeReference(code_hash);
+    BOOST_CHECK_EQUAL(code_store.size(), 0);
+
+    // dropped from memory, but still in the storage
+    BOOST_CHECK(*code_store.find(code_hash) == code);
+
+    lk::CodeStore memory_code_store;
+    memory_code_store.addReference(code_hash, std::make_shared<const base::Bytes>(code));
+    memory_code_store.removeReference(code_hash);
+    BOOST_CHECK_THROW(memory_code_store.find(code_hash), base::DatabaseError);
+}
+
+
+BOOST_AUTO_TEST_CASE(code_store_loads_restored_code_lazily)
+{
+    const base::Bytes code{ "runtime" };
+    const auto code_hash = base::Sha256::compute(code);
+    MapCodeStorage storage;
+    storage.codes.emplace(code_hash, code);
+
+    lk::CodeStore code_store;
+    code_store.setStorage(storage);
+    code_store.addReference(code_hash);
+    BOOST_CHECK_EQUAL(storage.reads_count, 0);
+
+    auto loaded_code = code_store.find(code_hash);
+    BOOST_CHECK(*loaded_code == code);
+    BOOST_CHECK(code_store.find(code_hash) == loaded_code);
+    BOOST_CHECK_EQUAL(storage.reads_count, 1);
+
+    // the code known from the storage isn't handed out to be written again
+    code_store.addReference(code_hash, std::make_shared<const base::Bytes>(code));
+    BOOST_CHECK(code_store.takeNewCode().empty());
+}
@@ -0,0 +1,209 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/managers.hpp"
+
+namespace
+{
+
+class MapCodeStorage : public lk::ICodeStorage
+{
+  public:
+    std::optional<base::Bytes> findContractCode(const base::Sha256& code_hash) const override
+    {
+        if (auto it = codes.find(code_hash); it != codes.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    // the node stores new code together with the block deploying it
+    void storeNewCode(lk::StateManager& state_manager)
+    {
+        for (const auto& [code_hash, code] : state_manager.takeNewContractsCode()) {
+            codes.insert_or_assign(code_hash, *code);
+        }
+    }
+
+    std::map<base::Sha256, base::Bytes> codes;
+};
+
+
+lk::StorageSlot makeSlot(const std::string& value)
+{
+    lk::StorageSlot slot;
+    std::copy(value.begin(), value.end(), slot.getData());
+    return slot;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(state_manager_snapshot_restores_accounts)
+{
+    lk::Address client_address(base::Secp256PrivateKey().toPublicKey());
+    lk::Address other_address(base::Secp256PrivateKey().toPublicKey());
+
+    MapCodeStorage storage;
+    lk::StateManager state_manager;
+    state_manager.setCodeStorage(storage);
+    state_manager.applyBlockEmission(client_address, 1000);
+    BOOST_CHECK(state_manager.registerTransaction(client_address) == 0);
+    BOOST_CHECK(state_manager.payFee(client_address, other_address, 300));
+
+    auto contract_code_hash = base::Sha256::compute(base::Bytes("code"));
+    auto storage_key = makeSlot("key");
+    auto commit = state_manager.createCommit();
+    auto contract_address = commit.createContractAccount(client_address, contract_code_hash);
+    commit.setRuntimeCode(contract_address, base::Bytes("runtime"));
+    commit.setStorageValue(contract_address, storage_key, makeSlot("value"));
+    state_manager.applyCommit(std::move(commit));
+    storage.storeNewCode(state_manager);
+
+    lk::StateManager restored_state_manager;
+    restored_state_manager.setCodeStorage(storage);
+    restored_state_manager.restoreSnapshot(state_manager.takeSnapshot());
+
+    auto client_info = restored_state_manager.getAccountInfo(client_address);
+    BOOST_CHECK(client_info.balance == 700);
+    BOOST_CHECK(client_info.nonce == 1);
+    BOOST_CHECK(client_info.transactions_count == 1);
+    BOOST_CHECK(restored_state_manager.getBalance(other_address) == 300);
+
+    auto restored_commit = restored_state_manager.createCommit();
+    BOOST_CHECK(restored_commit.getAccountType(contract_address) == lk::AccountType::CONTRACT);
+    BOOST_CHECK(restored_commit.getCodeHash(contract_address) == base::Sha256::compute(base::Bytes("runtime")));
+    BOOST_CHECK(*restored_commit.getRuntimeCode(contract_address) == base::Bytes("runtime"));
+    BOOST_CHECK(restored_commit.getStorageValue(contract_address, storage_key) == makeSlot("value"));
+}
+
+
+BOOST_AUTO_TEST_CASE(state_manager_snapshot_replaces_current_state)
+{
+    lk::Address address(base::Secp256PrivateKey().toPublicKey());
+
+    lk::StateManager empty_state_manager;
+    auto empty_snapshot = empty_state_manager.takeSnapshot();
+
+    lk::StateManager state_manager;
+    state_manager.applyBlockEmission(address, 10);
+    BOOST_CHECK(state_manager.hasAccount(address));
+
+    state_manager.restoreSnapshot(empty_snapshot);
+    BOOST_CHECK(!state_manager.hasAccount(address));
+}
+
+
+BOOST_AUTO_TEST_CASE(state_manager_register_transaction_returns_sequence_numbers)
+{
+    lk::Address address(base::Secp256PrivateKey().toPublicKey());
+
+    lk::StateManager state_manager;
+    BOOST_CHECK(state_manager.getAccountInfo(address).transactions_count == 0);
+
+    for (std::uint64_t i = 0; i < 5; ++i) {
+        BOOST_CHECK(state_manager.registerTransaction(address) == i);
+    }
+
+    auto info = state_manager.getAccountInfo(address);
+    BOOST_CHECK(info.transactions_count == 5);
+    BOOST_CHECK(info.nonce == 5);
+}
+
+
+BOOST_AUTO_TEST_CASE(state_manager_commit_changes_contract_only_when_applied)
+{
+    lk::Address client_address(base::Secp256PrivateKey().toPublicKey());
+    auto storage_key = makeSlot("key");
+
+    lk::StateManager state_manager;
+    state_manager.applyBlockEmission(client_address, 1000);
+    auto commit = state_manager.createCommit();
+    auto contract_address = commit.createContractAccount(client_address, base::Sha256::compute(base::Bytes("code")));
+    commit.setStorageValue(contract_address, storage_key, makeSlot("old"));
+    state_manager.applyCommit(std::move(commit));
+
+    // the new value is kept in the commit until it's applied
+    auto changing_commit = state_manager.createCommit();
+    changing_commit.setStorageValue(contract_address, storage_key, makeSlot("new"));
+    BOOST_CHECK(changing_commit.getStorageValue(contract_address, storage_key) == makeSlot("new"));
+    BOOST_CHECK(state_manager.createCommit().getStorageValue(contract_address, storage_key) == makeSlot("old"));
+    BOOST_CHECK(!changing_commit.findStorageValue(contract_address, makeSlot("unset")));
+    BOOST_CHECK(changing_commit.getStorageValue(contract_address, makeSlot("unset")) == lk::StorageSlot{});
+
+    state_manager.applyCommit(std::move(changing_commit));
+    BOOST_CHECK(state_manager.createCommit().getStorageValue(contract_address, storage_key) == makeSlot("new"));
+    BOOST_CHECK(state_manager.getBalance(client_address) == 1000);
+}
+
+
+BOOST_AUTO_TEST_CASE(state_manager_commit_applies_only_changes)
+{
+    lk::Address client_address(base::Secp256PrivateKey().toPublicKey());
+    lk::Address coinbase_address(base::Secp256PrivateKey().toPublicKey());
+    auto first_key = makeSlot("first");
+    auto second_key = makeSlot("second");
+
+    lk::StateManager state_manager;
+    state_manager.applyBlockEmission(client_address, 1000);
+    auto commit = state_manager.createCommit();
+    auto contract_address = commit.createContractAccount(client_address, base::Sha256::compute(base::Bytes("code")));
+    commit.setRuntimeCode(contract_address, base::Bytes("runtime"));
+    commit.setStorageValue(contract_address, first_key, makeSlot("first"));
+    commit.setStorageValue(contract_address, second_key, makeSlot("second"));
+    BOOST_CHECK(*commit.getRuntimeCode(contract_address) == base::Bytes("runtime"));
+    state_manager.applyCommit(std::move(commit));
+
+    auto transfer_commit = state_manager.createCommit();
+    BOOST_CHECK(transfer_commit.tryTransferMoney(client_address, contract_address, 100));
+    BOOST_CHECK(!transfer_commit.tryTransferMoney(client_address, contract_address, 901));
+    transfer_commit.setStorageValue(contract_address, second_key, makeSlot("changed"));
+    BOOST_CHECK(transfer_commit.getBalance(client_address) == 900);
+    BOOST_CHECK(transfer_commit.getBalance(contract_address) == 100);
+    BOOST_CHECK(transfer_commit.getStorageValue(contract_address, first_key) == makeSlot("first"));
+
+    // the fee is paid aside from the commit and isn't overwritten by it
+    BOOST_CHECK(state_manager.payFee(client_address, coinbase_address, 10));
+    state_manager.applyCommit(std::move(transfer_commit));
+
+    BOOST_CHECK(state_manager.getBalance(client_address) == 890);
+    BOOST_CHECK(state_manager.getBalance(coinbase_address) == 10);
+    BOOST_CHECK(state_manager.getBalance(contract_address) == 100);
+    auto check_commit = state_manager.createCommit();
+    BOOST_CHECK(check_commit.getStorageValue(contract_address, first_key) == makeSlot("first"));
+    BOOST_CHECK(check_commit.getStorageValue(contract_address, second_key) == makeSlot("changed"));
+    BOOST_CHECK(*check_commit.getRuntimeCode(contract_address) == base::Bytes("runtime"));
+}
+
+
+BOOST_AUTO_TEST_CASE(state_manager_contracts_share_code)
+{
+    lk::Address client_address(base::Secp256PrivateKey().toPublicKey());
+    MapCodeStorage storage;
+    lk::StateManager state_manager;
+    state_manager.setCodeStorage(storage);
+    state_manager.applyBlockEmission(client_address, 1000);
+
+    std::vector<lk::Address> contracts_addresses;
+    for (const auto& init_code : { base::Bytes("first init"), base::Bytes("second init") }) {
+        auto commit = state_manager.createCommit();
+        contracts_addresses.push_back(commit.createContractAccount(client_address, base::Sha256::compute(init_code)));
+        BOOST_CHECK(commit.getCodeHash(contracts_addresses.back()) == base::Sha256::null());
+        commit.setRuntimeCode(contracts_addresses.back(), base::Bytes("runtime"));
+        state_manager.applyCommit(std::move(commit));
+    }
+    BOOST_CHECK(storage.codes.empty());
+    storage.storeNewCode(state_manager);
+
+    auto commit = state_manager.createCommit();
+    BOOST_CHECK(commit.getRuntimeCode(contracts_addresses[0]) == commit.getRuntimeCode(contracts_addresses[1]));
+    BOOST_CHECK(commit.getCodeHash(contracts_addresses[0]) == base::Sha256::compute(base::Bytes("runtime")));
+    BOOST_CHECK_EQUAL(storage.codes.size(), 1);
+
+    // the snapshot holds only the code hash, the code itself is read from the storage
+    lk::StateManager restored_state_manager;
+    restored_state_manager.setCodeStorage(storage);
+    restored_state_manager.restoreSnapshot(state_manager.takeSnapshot());
+    auto restored_commit = restored_state_manager.createCommit();
+    BOOST_CHECK(*restored_commit.getRuntimeCode(contracts_addresses[1]) == base::Bytes("runtime"));
+    BOOST_CHECK(restored_commit.getCodeSize(contracts_addresses[0]) == base::Bytes("runtime").size());
+}
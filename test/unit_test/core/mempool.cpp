@@ -0,0 +1,211 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/mempool.hpp"
+
+#include "base/serialization.hpp"
+
+namespace
+{
+
+lk::Address makeAddress(char c)
+{
+    return lk::Address{ base::Bytes(std::string(lk::Address::LENGTH_IN_BYTES, c)) };
+}
+
+
+lk::Transaction makeTransaction(const lk::Address& from,
+                                lk::Fee fee,
+                                std::uint32_t timestamp,
+                                const base::Bytes& data = base::Bytes{})
+{
+    return lk::Transaction{ from, makeAddress('t'), 100, fee, base::Time(timestamp), data };
+}
+
+
+const lk::Mempool::Limits NO_LIMITS{ 1'000'000, 1'000'000'000, std::chrono::seconds{ 1'000'000 } };
+const base::Time NOW{ 1000 };
+
+
+lk::Mempool::AdditionResult add(lk::Mempool& mempool, const lk::Transaction& tx)
+{
+    std::vector<lk::Transaction> evicted;
+    return mempool.add(tx, NOW, evicted);
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(mempool_add_find_remove)
+{
+    lk::Mempool mempool{ 2, NO_LIMITS };
+    auto tx1 = makeTransaction(makeAddress('a'), 10, 1);
+    auto tx2 = makeTransaction(makeAddress('a'), 30, 2);
+    auto tx3 = makeTransaction(makeAddress('b'), 20, 3);
+
+    BOOST_CHECK(add(mempool, tx1) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(add(mempool, tx2) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(add(mempool, tx3) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(add(mempool, tx2) == lk::Mempool::AdditionResult::ALREADY_PENDING);
+    BOOST_CHECK_EQUAL(mempool.size(), 3);
+    BOOST_CHECK(mempool.contains(tx1.hashOfTransaction()));
+    BOOST_CHECK(mempool.find(tx3.hashOfTransaction()) == tx3);
+
+    lk::TransactionsSet block_txs;
+    block_txs.add(tx1);
+    block_txs.add(tx3);
+    mempool.remove(block_txs);
+    BOOST_CHECK_EQUAL(mempool.size(), 1);
+    BOOST_CHECK(!mempool.contains(tx1.hashOfTransaction()));
+    BOOST_CHECK(!mempool.find(tx3.hashOfTransaction()));
+    BOOST_CHECK(mempool.getSenderTransactions(makeAddress('b')).empty());
+
+    mempool.remove(tx2.hashOfTransaction());
+    mempool.remove(tx2.hashOfTransaction());
+    BOOST_CHECK_EQUAL(mempool.size(), 0);
+    BOOST_CHECK(mempool.getBlockTransactions().isEmpty());
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_sender_transactions_in_arrival_order)
+{
+    lk::Mempool mempool{ 10, NO_LIMITS };
+    auto sender = makeAddress('a');
+    auto tx1 = makeTransaction(sender, 10, 3);
+    auto tx2 = makeTransaction(sender, 5, 1);
+    auto tx3 = makeTransaction(sender, 7, 2);
+    add(mempool, tx1);
+    add(mempool, makeTransaction(makeAddress('b'), 1, 1));
+    add(mempool, tx2);
+    add(mempool, tx3);
+
+    auto sender_txs = mempool.getSenderTransactions(sender);
+    BOOST_REQUIRE_EQUAL(sender_txs.size(), 3);
+    BOOST_CHECK(*sender_txs[0] == tx1);
+    BOOST_CHECK(*sender_txs[1] == tx2);
+    BOOST_CHECK(*sender_txs[2] == tx3);
+
+    mempool.remove(tx2.hashOfTransaction());
+    sender_txs = mempool.getSenderTransactions(sender);
+    BOOST_REQUIRE_EQUAL(sender_txs.size(), 2);
+    BOOST_CHECK(*sender_txs[0] == tx1);
+    BOOST_CHECK(*sender_txs[1] == tx3);
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_block_transactions_are_best_by_fee)
+{
+    lk::Mempool mempool{ 2, NO_LIMITS };
+    auto tx1 = makeTransaction(makeAddress('a'), 10, 1);
+    auto tx2 = makeTransaction(makeAddress('b'), 30, 2);
+    auto tx3 = makeTransaction(makeAddress('c'), 20, 3);
+    add(mempool, tx1);
+    add(mempool, tx2);
+    add(mempool, tx3);
+
+    auto block_txs = mempool.getBlockTransactions();
+    BOOST_CHECK_EQUAL(block_txs.size(), 2);
+    BOOST_CHECK(block_txs.find(tx2));
+    BOOST_CHECK(block_txs.find(tx3));
+    BOOST_CHECK(mempool.getBlockFeeValue() == lk::Balance{ 50 });
+
+    mempool.remove(tx2.hashOfTransaction());
+    BOOST_CHECK(mempool.getBlockTransactions().find(tx1));
+    BOOST_CHECK(mempool.getBlockFeeValue() == lk::Balance{ 30 });
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_pending_spend)
+{
+    lk::Mempool mempool{ 10, NO_LIMITS };
+    auto sender = makeAddress('a');
+    auto tx1 = makeTransaction(sender, 10, 1);
+    auto tx2 = makeTransaction(sender, 20, 2);
+    BOOST_CHECK(mempool.getPendingSpend(sender) == lk::Balance{ 0 });
+
+    add(mempool, tx1);
+    add(mempool, tx2);
+    add(mempool, tx2);
+    add(mempool, makeTransaction(makeAddress('b'), 5, 3));
+    BOOST_CHECK(mempool.getPendingSpend(sender) == lk::Balance{ 100 + 10 + 100 + 20 });
+
+    lk::TransactionsSet block_txs;
+    block_txs.add(tx1);
+    mempool.remove(block_txs);
+    BOOST_CHECK(mempool.getPendingSpend(sender) == lk::Balance{ 100 + 20 });
+
+    mempool.remove(tx2.hashOfTransaction());
+    BOOST_CHECK(mempool.getPendingSpend(sender) == lk::Balance{ 0 });
+    BOOST_CHECK(mempool.getPendingSpend(makeAddress('b')) == lk::Balance{ 100 + 5 });
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_evicts_lowest_fee_per_byte)
+{
+    auto small = makeTransaction(makeAddress('a'), 100, 1);
+    auto big = makeTransaction(makeAddress('b'), 100, 2, base::Bytes(std::string(1000, 'x')));
+    auto cheap = makeTransaction(makeAddress('c'), 10, 3);
+    auto generous = makeTransaction(makeAddress('d'), 200, 4);
+
+    lk::Mempool mempool{ 10, { 2, 1'000'000, std::chrono::seconds{ 1'000'000 } } };
+    BOOST_CHECK(add(mempool, small) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(add(mempool, big) == lk::Mempool::AdditionResult::ADDED);
+    const auto bytes_size = mempool.getBytesSize();
+    BOOST_CHECK_EQUAL(bytes_size, base::toBytes(small).size() + base::toBytes(big).size());
+
+    // the same fee, but the big one pays less per byte
+    std::vector<lk::Transaction> evicted;
+    BOOST_CHECK(mempool.add(generous, NOW, evicted) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_REQUIRE_EQUAL(evicted.size(), 1);
+    BOOST_CHECK(evicted[0] == big);
+    BOOST_CHECK(!mempool.contains(big.hashOfTransaction()));
+    BOOST_CHECK(mempool.getPendingSpend(makeAddress('b')) == lk::Balance{ 0 });
+
+    // nothing pays less than this one, so it is not added and nothing is evicted
+    evicted.clear();
+    BOOST_CHECK(mempool.add(cheap, NOW, evicted) == lk::Mempool::AdditionResult::MEMPOOL_FULL);
+    BOOST_CHECK(evicted.empty());
+    BOOST_CHECK_EQUAL(mempool.size(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_bytes_limit)
+{
+    auto tx1 = makeTransaction(makeAddress('a'), 10, 1);
+    auto tx2 = makeTransaction(makeAddress('b'), 20, 2);
+    auto tx3 = makeTransaction(makeAddress('c'), 30, 3);
+    const auto tx_size = base::toBytes(tx1).size();
+
+    lk::Mempool mempool{ 10, { 100, 2 * tx_size, std::chrono::seconds{ 1'000'000 } } };
+    add(mempool, tx1);
+    add(mempool, tx2);
+    std::vector<lk::Transaction> evicted;
+    BOOST_CHECK(mempool.add(tx3, NOW, evicted) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_REQUIRE_EQUAL(evicted.size(), 1);
+    BOOST_CHECK(evicted[0] == tx1);
+    BOOST_CHECK(mempool.getBytesSize() <= 2 * tx_size);
+
+    auto too_big = makeTransaction(makeAddress('d'), 1'000'000, 4, base::Bytes(std::string(3 * tx_size, 'x')));
+    BOOST_CHECK(add(mempool, too_big) == lk::Mempool::AdditionResult::MEMPOOL_FULL);
+    BOOST_CHECK_EQUAL(mempool.size(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(mempool_expires_old_transactions)
+{
+    lk::Mempool mempool{ 10, { 100, 1'000'000, std::chrono::seconds{ 100 } } };
+    auto old_tx = makeTransaction(makeAddress('a'), 10, 100);
+    auto new_tx = makeTransaction(makeAddress('b'), 10, 150);
+
+    std::vector<lk::Transaction> evicted;
+    BOOST_CHECK(mempool.add(old_tx, base::Time{ 150 }, evicted) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(mempool.add(new_tx, base::Time{ 150 }, evicted) == lk::Mempool::AdditionResult::ADDED);
+    BOOST_CHECK(mempool.add(makeTransaction(makeAddress('c'), 10, 10), base::Time{ 150 }, evicted) ==
+                lk::Mempool::AdditionResult::EXPIRED);
+
+    BOOST_CHECK(mempool.removeExpired(base::Time{ 200 }).empty());
+    auto expired = mempool.removeExpired(base::Time{ 201 });
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK(expired[0] == old_tx);
+    BOOST_CHECK_EQUAL(mempool.size(), 1);
+    BOOST_CHECK(mempool.contains(new_tx.hashOfTransaction()));
+}
@@ -0,0 +1,122 @@
+#include <boost/test/unit_test.hpp>
+
+#include "core/signature_verifier.hpp"
+
+namespace
+{
+
+lk::Transaction makeSignedTransaction(const base::Secp256PrivateKey& key, lk::Balance amount)
+{
+    lk::Address from{ key.toPublicKey() };
+    lk::Address to{ base::Secp256PrivateKey().toPublicKey() };
+    lk::Transaction tx{ from, to, amount, 42, base::Time::now(), base::Bytes{} };
+    tx.sign(key);
+    return tx;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_CASE(signature_verifier_verify)
+{
+    lk::SignatureVerifier verifier{ 2, 16 };
+    base::Secp256PrivateKey key;
+    auto tx = makeSignedTransaction(key, 100);
+    BOOST_CHECK(verifier.verify(tx));
+    BOOST_CHECK(verifier.verify(tx));
+
+    lk::Transaction not_signed{ tx.getFrom(), tx.getTo(), 100, 42, base::Time::now(), base::Bytes{} };
+    BOOST_CHECK(!verifier.verify(not_signed));
+
+    // signed by a key that doesn't match the sender address
+    lk::Transaction wrong_key{ tx.getFrom(), tx.getTo(), 200, 42, base::Time::now(), base::Bytes{} };
+    wrong_key.sign(base::Secp256PrivateKey());
+    BOOST_CHECK(!verifier.verify(wrong_key));
+}
+
+
+BOOST_AUTO_TEST_CASE(signature_verifier_verify_all_in_parallel)
+{
+    lk::SignatureVerifier verifier{ 4, 128 };
+    base::Secp256PrivateKey key;
+    lk::TransactionsSet txs;
+    for (lk::Balance amount = 1; amount <= 50; ++amount) {
+        txs.add(makeSignedTransaction(key, amount));
+    }
+    BOOST_CHECK(verifier.verifyAll(txs));
+    BOOST_CHECK(verifier.verifyAll(txs)); // now all of them are taken from the verified ones
+    BOOST_CHECK(verifier.verifyAll(lk::TransactionsSet{}));
+
+    lk::Transaction wrong_key{ txs.begin()->getFrom(), txs.begin()->getTo(), 1000, 42, base::Time::now(), {} };
+    wrong_key.sign(base::Secp256PrivateKey());
+    txs.add(wrong_key);
+    BOOST_CHECK(!verifier.verifyAll(txs));
+}
+
+
+BOOST_AUTO_TEST_CASE(signature_verifier_verify_each_in_parallel)
+{
+    lk::SignatureVerifier verifier{ 4, 128 };
+    base::Secp256PrivateKey key;
+    std::vector<lk::Transaction> txs;
+    std::vector<bool> expected;
+    for (lk::Balance amount = 1; amount <= 50; ++amount) {
+        auto tx = makeSignedTransaction(key, amount);
+        if (amount % 7 == 0) {
+            tx.sign(base::Secp256PrivateKey()); // the key doesn't match the sender address
+        }
+        expected.push_back(amount % 7 != 0);
+        txs.push_back(std::move(tx));
+    }
+    BOOST_CHECK(verifier.verifyEach(txs) == expected);
+    BOOST_CHECK(verifier.verifyEach(txs) == expected); // valid ones are taken from the verified ones
+    BOOST_CHECK(verifier.verifyEach({}).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(signature_verifier_rejects_tampered_sign_of_verified)
+{
+    lk::SignatureVerifier verifier{ 2, 16 };
+    base::Secp256PrivateKey key;
+    auto tx = makeSignedTransaction(key, 100);
+    BOOST_CHECK(verifier.verify(tx));
+
+    // the same content, so the same hash, but the signature isn't the checked one
+    lk::Transaction garbage_sign{
+        tx.getFrom(), tx.getTo(), tx.getAmount(), tx.getFee(), tx.getTimestamp(), tx.getData(), lk::Sign{}
+    };
+    BOOST_CHECK(garbage_sign.hashOfTransaction() == tx.hashOfTransaction());
+    BOOST_CHECK(!verifier.verify(garbage_sign));
+
+    auto resigned = tx;
+    resigned.sign(base::Secp256PrivateKey());
+    BOOST_CHECK(!verifier.verify(resigned));
+
+    lk::TransactionsSet txs;
+    txs.add(resigned);
+    BOOST_CHECK(!verifier.verifyAll(txs));
+    BOOST_CHECK(verifier.verify(tx));
+}
+
+
+BOOST_AUTO_TEST_CASE(signature_verifier_verify_each_rejects_tampered_duplicates)
+{
+    lk::SignatureVerifier verifier{ 4, 128 };
+    base::Secp256PrivateKey key;
+    std::vector<lk::Transaction> txs;
+    for (lk::Balance amount = 1; amount <= 20; ++amount) {
+        txs.push_back(makeSignedTransaction(key, amount));
+    }
+    BOOST_CHECK(verifier.verifyEach(txs) == std::vector<bool>(txs.size(), true));
+
+    // every valid signature is cached now, the batch repeats one transaction re-signed and one with a garbage sign
+    auto resigned = txs[3];
+    resigned.sign(base::Secp256PrivateKey());
+    const auto& original = txs[5];
+    lk::Transaction garbage_sign{
+        original.getFrom(), original.getTo(), original.getAmount(), original.getFee(), original.getTimestamp(),
+        original.getData(), lk::Sign{}
+    };
+    std::vector<lk::Transaction> batch{ txs[0], resigned, txs[1], garbage_sign, txs[3] };
+    BOOST_CHECK(verifier.verifyEach(batch) == std::vector<bool>({ true, false, true, false, true }));
+}
@@ -147,6 +147,33 @@ BOOST_AUTO_TEST_CASE(transaction_serialization2)
 }
 
 
+BOOST_AUTO_TEST_CASE(transaction_hash_matches_specification)
+{
+    lk::Address from = lk::Address(base::Secp256PrivateKey().toPublicKey());
+    lk::Balance max_amount = 0;
+    max_amount = ~max_amount;
+
+    for (std::size_t data_size = 0; data_size < 300; data_size += 7) {
+        base::Bytes data(data_size);
+        for (std::size_t i = 0; i < data_size; ++i) {
+            data[i] = static_cast<base::Byte>(i * 31 + 7);
+        }
+        lk::Balance amount = data_size % 2 ? max_amount : lk::Balance{ data_size };
+        std::uint64_t fee = 1 + data_size * 1'000'000'000'000ULL;
+        base::Time time{ static_cast<std::uint_least32_t>(1583789617 + data_size) };
+        lk::Transaction tx(from, lk::Address::null(), amount, fee, time, data);
+
+        auto expected_data = base::base58Encode(from.getBytes()) + base::base58Encode(lk::Address::null().getBytes()) +
+                             amount.str() + std::to_string(fee) + std::to_string(time.getSeconds()) +
+                             base::base64Encode(data);
+        BOOST_CHECK(tx.hashOfTransaction() == base::Sha256::compute(base::Bytes(expected_data)));
+
+        auto deserialized_tx = base::fromBytes<lk::Transaction>(base::toBytes(tx));
+        BOOST_CHECK(deserialized_tx.hashOfTransaction() == tx.hashOfTransaction());
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(transaction_builder_set_all1)
 {
     lk::Address from = lk::Address(base::Secp256PrivateKey().toPublicKey());
@@ -216,3 +216,19 @@ BOOST_AUTO_TEST_CASE(transactions_set_serialixation)
     BOOST_CHECK(tx_set2.find(trans4));
     BOOST_CHECK(tx_set2.find(trans5));
 }
+
+
+BOOST_AUTO_TEST_CASE(transactions_set_calc_cost_sums_all_sender_transactions)
+{
+    lk::Address sender{ base::Bytes("sender address bytes") };
+    lk::Address other{ base::Bytes("other address bytes!") };
+    lk::TransactionsSet tx_set;
+    tx_set.add({ sender, other, 100, 1, base::Time(1), base::Bytes{} });
+    tx_set.add({ sender, other, 200, 2, base::Time(2), base::Bytes{} });
+    tx_set.add({ other, sender, 50, 5, base::Time(3), base::Bytes{} });
+
+    auto cost = lk::calcCost(tx_set);
+    BOOST_CHECK_EQUAL(cost.size(), 2);
+    BOOST_CHECK(cost[sender] == lk::Balance{ 303 });
+    BOOST_CHECK(cost[other] == lk::Balance{ 55 });
+}
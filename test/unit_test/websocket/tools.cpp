@@ -0,0 +1,43 @@
+#include <boost/test/unit_test.hpp>
+
+#include "websocket/tools.hpp"
+
+BOOST_AUTO_TEST_CASE(websocket_blocks_cache_statistics_command_name)
+{
+    BOOST_CHECK(websocket::deserializeCommandName("blocks_cache_statistics") ==
+                websocket::Command::Name::BLOCKS_CACHE_STATISTICS);
+    BOOST_CHECK(websocket::serializeCommandName(websocket::Command::CALL_BLOCKS_CACHE_STATISTICS).as_string() ==
+                "blocks_cache_statistics");
+}
+
+
+BOOST_AUTO_TEST_CASE(websocket_blocks_cache_statistics_serialization)
+{
+    lk::Address coinbase{ base::Bytes("coinbase address!!!!") };
+    lk::TransactionsSet txs;
+    txs.add(lk::Transaction{ lk::Address::null(), coinbase, 1000, 0, base::Time(1583789617), base::Bytes{} });
+    lk::ImmutableBlock genesis{ 0, 0, base::Sha256::null(), base::Time(1583789617), coinbase, std::move(txs) };
+
+    lk::Blockchain blockchain{ genesis, 1024 };
+    BOOST_CHECK(!blockchain.findBlock(base::Sha256::compute(base::Bytes("unknown block"))));
+
+    auto stats = blockchain.getBlocksCacheStats();
+    BOOST_CHECK(stats.misses == 1);
+    BOOST_CHECK(stats.size == 1);
+    BOOST_CHECK(stats.weight == genesis.getSerialized().size());
+    BOOST_CHECK(stats.capacity == 1024);
+
+    auto stats_value = websocket::serializeBlocksCacheStats(stats);
+    BOOST_CHECK(stats_value["misses"].as_number().to_uint64() == 1);
+    BOOST_CHECK(stats_value["capacity_bytes"].as_number().to_uint64() == 1024);
+
+    auto restored_stats = websocket::deserializeBlocksCacheStats(stats_value);
+    BOOST_CHECK(restored_stats.hits == stats.hits);
+    BOOST_CHECK(restored_stats.misses == stats.misses);
+    BOOST_CHECK(restored_stats.size == stats.size);
+    BOOST_CHECK(restored_stats.weight == stats.weight);
+    BOOST_CHECK(restored_stats.capacity == stats.capacity);
+
+    stats_value.erase("bytes");
+    BOOST_CHECK_THROW(websocket::deserializeBlocksCacheStats(stats_value), base::InvalidArgument);
+}